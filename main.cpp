@@ -7,7 +7,8 @@
 #include <random>
 
 constexpr int FRAME_SIZE_BITS = 100;
-constexpr int FRAME_SIZE_BYTES = FRAME_SIZE_BITS / 8;
+constexpr int FRAME_SIZE_BYTES = (FRAME_SIZE_BITS + 7) / 8;
+constexpr int CRC_BITS = 16;
 constexpr uint16_t CRC_POLY = 0x1021; // x^16 + x^12 + x^5 + 1
 
 class MainFrame : public wxFrame {
@@ -173,20 +174,20 @@ private:
     }
 
     std::string CalculateCRC(const std::string& frame) {
-        std::string data = frame + std::string(16, '0');
-        std::bitset<116> bits(data);
-        std::bitset<17> poly(CRC_POLY);
+        std::string data = frame + std::string(CRC_BITS, '0');
+        std::bitset<FRAME_SIZE_BITS + CRC_BITS> bits(data);
+        std::bitset<CRC_BITS + 1> poly(CRC_POLY);
 
-        for (int i = 115; i >= 16; --i) {
+        for (int i = FRAME_SIZE_BITS + CRC_BITS - 1; i >= CRC_BITS; --i) {
             if (bits[i]) {
-                for (int j = 0; j <= 16; ++j) {
-                    bits[i - j] = bits[i - j] ^ poly[16 - j];
+                for (int j = 0; j <= CRC_BITS; ++j) {
+                    bits[i - j] = bits[i - j] ^ poly[CRC_BITS - j];
                 }
             }
         }
 
-        std::bitset<16> crc;
-        for (int i = 0; i < 16; ++i) crc[i] = bits[i];
+        std::bitset<CRC_BITS> crc;
+        for (int i = 0; i < CRC_BITS; ++i) crc[i] = bits[i];
         return crc.to_string();
     }
 
@@ -0,0 +1,62 @@
+#include "bitpacker.h"
+#include <QtEndian>
+#include <cstring>
+
+void BitPacker::extractBits(const uchar *source, qint64 sourceSize, qint64 bitOffset,
+                            int bitCount, uchar *out)
+{
+    const int outBytes = (bitCount + 7) / 8;
+    const qint64 availableBits = qMax<qint64>(0, sourceSize * 8 - bitOffset);
+    const int bits = static_cast<int>(qMin<qint64>(bitCount, availableBits));
+
+    // Each 64-bit load yields at least 56 usable bits after the sub-byte shift,
+    // so the output is produced seven bytes per step.
+    int outPos = 0;
+    for (int j = 0; j < bits; j += 56) {
+        const qint64 bit = bitOffset + j;
+        const quint64 word = loadBigEndian64(source, sourceSize, bit >> 3) << (bit & 7);
+        const int chunk = qMin(7, outBytes - outPos);
+        for (int k = 0; k < chunk; ++k) {
+            out[outPos + k] = static_cast<uchar>(word >> (56 - 8 * k));
+        }
+        outPos += chunk;
+    }
+
+    // Clear whatever was copied past the requested bit count, then zero-fill
+    const int usedBytes = (bits + 7) / 8;
+    if (bits % 8) {
+        out[usedBytes - 1] &= static_cast<uchar>(0xFF << (8 - bits % 8));
+    }
+    if (usedBytes < outBytes) {
+        std::memset(out + usedBytes, 0, outBytes - usedBytes);
+    }
+}
+
+void BitPacker::extractBitsReference(const uchar *source, qint64 sourceSize, qint64 bitOffset,
+                                     int bitCount, uchar *out)
+{
+    std::memset(out, 0, (bitCount + 7) / 8);
+    for (int j = 0; j < bitCount; ++j) {
+        const qint64 bit = bitOffset + j;
+        if (bit >= sourceSize * 8) {
+            break;
+        }
+        if (source[bit / 8] & (1 << (7 - bit % 8))) {
+            out[j / 8] |= (1 << (7 - j % 8));
+        }
+    }
+}
+
+quint64 BitPacker::loadBigEndian64(const uchar *source, qint64 sourceSize, qint64 byteOffset)
+{
+    if (byteOffset + 8 <= sourceSize) {
+        return qFromBigEndian<quint64>(source + byteOffset);
+    }
+
+    // Near the end of the buffer: copy what is left and pad with zeros
+    uchar tail[8] = {};
+    if (byteOffset < sourceSize) {
+        std::memcpy(tail, source + byteOffset, sourceSize - byteOffset);
+    }
+    return qFromBigEndian<quint64>(tail);
+}
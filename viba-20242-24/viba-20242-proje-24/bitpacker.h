@@ -0,0 +1,24 @@
+#ifndef BITPACKER_H
+#define BITPACKER_H
+
+#include <QtGlobal>
+
+// Extracts bit ranges (MSB-first) from a byte buffer into byte-aligned output,
+// as used to cut the input file into frames that do not start on byte boundaries.
+class BitPacker
+{
+public:
+    // Copies bitCount bits starting at bitOffset into out, which must hold
+    // (bitCount + 7) / 8 bytes. Bits past the end of the source read as 0.
+    static void extractBits(const uchar *source, qint64 sourceSize, qint64 bitOffset,
+                            int bitCount, uchar *out);
+
+    // Bit-at-a-time implementation, kept as the reference for extractBits
+    static void extractBitsReference(const uchar *source, qint64 sourceSize, qint64 bitOffset,
+                                     int bitCount, uchar *out);
+
+private:
+    static quint64 loadBigEndian64(const uchar *source, qint64 sourceSize, qint64 byteOffset);
+};
+
+#endif // BITPACKER_H
@@ -0,0 +1,296 @@
+#include "bitstuffing.h"
+#include <QtEndian>
+#include <array>
+
+namespace {
+
+// What one input byte produces, given the run of 1s carried into it
+struct StuffStep {
+    quint16 bits;  // Up to 10 output bits, right-aligned
+    quint8 length;
+    quint8 ones;   // Run of 1s carried into the next byte
+};
+
+struct DestuffStep {
+    quint8 bits;
+    quint8 length;
+    quint8 ones;
+    bool flag;     // Holds a sixth 1: the closing flag or an abort
+};
+
+using StuffTable = std::array<std::array<StuffStep, 256>, BitStuffing::MAX_ONES>;
+using DestuffTable = std::array<std::array<DestuffStep, 256>, BitStuffing::MAX_ONES + 1>;
+
+constexpr StuffTable makeStuffTable()
+{
+    StuffTable table{};
+    for (int ones = 0; ones < BitStuffing::MAX_ONES; ++ones) {
+        for (int byte = 0; byte < 256; ++byte) {
+            StuffStep step{0, 0, 0};
+            int run = ones;
+            for (int i = 7; i >= 0; --i) {
+                const int bit = (byte >> i) & 1;
+                step.bits = static_cast<quint16>((step.bits << 1) | bit);
+                step.length++;
+                run = bit ? run + 1 : 0;
+                if (run == BitStuffing::MAX_ONES) {
+                    step.bits = static_cast<quint16>(step.bits << 1);
+                    step.length++;
+                    run = 0;
+                }
+            }
+            step.ones = static_cast<quint8>(run);
+            table[ones][byte] = step;
+        }
+    }
+    return table;
+}
+
+constexpr DestuffTable makeDestuffTable()
+{
+    DestuffTable table{};
+    for (int ones = 0; ones <= BitStuffing::MAX_ONES; ++ones) {
+        for (int byte = 0; byte < 256; ++byte) {
+            DestuffStep step{0, 0, 0, false};
+            int run = ones;
+            for (int i = 7; i >= 0 && !step.flag; --i) {
+                const int bit = (byte >> i) & 1;
+                if (run == BitStuffing::MAX_ONES) {
+                    if (bit) {
+                        step.flag = true;
+                    }
+                    run = 0; // Inserted 0, dropped
+                    continue;
+                }
+                step.bits = static_cast<quint8>((step.bits << 1) | bit);
+                step.length++;
+                run = bit ? run + 1 : 0;
+            }
+            step.ones = static_cast<quint8>(run);
+            table[ones][byte] = step;
+        }
+    }
+    return table;
+}
+
+constexpr StuffTable STUFF_TABLE = makeStuffTable();
+constexpr DestuffTable DESTUFF_TABLE = makeDestuffTable();
+
+// Appends MSB-first bit strings to a byte buffer with room for all of them
+class BitWriter
+{
+public:
+    explicit BitWriter(uchar *out) : out(out) {}
+
+    // length is at most 32 bits
+    void write(quint32 bits, int length)
+    {
+        accumulator = (accumulator << length) | bits;
+        pending += length;
+        written += length;
+        if (pending >= 32) {
+            pending -= 32;
+            qToBigEndian(static_cast<quint32>(accumulator >> pending), out);
+            out += 4;
+        }
+    }
+
+    void flush()
+    {
+        while (pending >= 8) {
+            pending -= 8;
+            *out++ = static_cast<uchar>(accumulator >> pending);
+        }
+        if (pending > 0) {
+            *out++ = static_cast<uchar>(accumulator << (8 - pending));
+            pending = 0;
+        }
+    }
+
+    qint64 bitCount() const { return written; }
+
+private:
+    quint64 accumulator = 0;
+    int pending = 0;
+    qint64 written = 0;
+    uchar *out;
+};
+
+inline int bitAt(const uchar *data, qint64 bit)
+{
+    return (data[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+inline void stuffBit(BitWriter &writer, int bit, int &ones)
+{
+    writer.write(bit, 1);
+    ones = bit ? ones + 1 : 0;
+    if (ones == BitStuffing::MAX_ONES) {
+        writer.write(0, 1);
+        ones = 0;
+    }
+}
+
+// Destuffs bit by bit from bit up to the closing flag. Returns the payload
+// bit count, or -1 for an abort or a missing flag.
+qint64 destuffToFlag(const uchar *wire, qint64 wireBits, qint64 bit, BitWriter &writer, int ones)
+{
+    for (; bit < wireBits; ++bit) {
+        const int value = bitAt(wire, bit);
+        if (ones < BitStuffing::MAX_ONES) {
+            writer.write(value, 1);
+            ones = value ? ones + 1 : 0;
+        } else if (!value) {
+            ones = 0; // Inserted 0
+        } else {
+            // Sixth 1: a flag if a 0 follows, else an abort. The flag's
+            // leading 0 and first five 1s have gone out as payload.
+            if (bit + 1 >= wireBits || bitAt(wire, bit + 1)) {
+                return -1;
+            }
+            return writer.bitCount() - (BitStuffing::MAX_ONES + 1);
+        }
+    }
+    return -1;
+}
+
+// Trims the decoded buffer to bits and clears the padding after them
+void finishPayload(QByteArray &payload, qint64 bits, qint64 *bitCount)
+{
+    if (bitCount) {
+        *bitCount = qMax<qint64>(0, bits);
+    }
+    if (bits < 0) {
+        payload = QByteArray();
+        return;
+    }
+    payload.resize((bits + 7) / 8);
+    if (bits % 8) {
+        uchar *last = reinterpret_cast<uchar *>(payload.data()) + payload.size() - 1;
+        *last &= static_cast<uchar>(0xFF << (8 - bits % 8));
+    }
+}
+
+qint64 clampBits(const QByteArray &data, qint64 bitCount)
+{
+    return qBound<qint64>(0, bitCount, qint64(data.size()) * 8);
+}
+
+qsizetype stuffedCapacity(qint64 bits)
+{
+    // At most one inserted bit per five payload bits, plus both flags
+    return (2 * BitStuffing::FLAG_BITS + bits + bits / BitStuffing::MAX_ONES + 7) / 8;
+}
+
+}
+
+QByteArray BitStuffing::stuff(const QByteArray &data, qint64 bitCount)
+{
+    const qint64 bits = clampBits(data, bitCount);
+    const uchar *source = reinterpret_cast<const uchar *>(data.constData());
+    QByteArray wire(stuffedCapacity(bits), Qt::Uninitialized);
+    BitWriter writer(reinterpret_cast<uchar *>(wire.data()));
+
+    writer.write(FLAG, FLAG_BITS);
+    int ones = 0;
+    const qint64 fullBytes = bits / 8;
+    for (qint64 i = 0; i < fullBytes; ++i) {
+        const StuffStep &step = STUFF_TABLE[ones][source[i]];
+        writer.write(step.bits, step.length);
+        ones = step.ones;
+    }
+    for (qint64 bit = fullBytes * 8; bit < bits; ++bit) {
+        stuffBit(writer, bitAt(source, bit), ones);
+    }
+    writer.write(FLAG, FLAG_BITS);
+    writer.flush();
+
+    wire.resize((writer.bitCount() + 7) / 8);
+    return wire;
+}
+
+QByteArray BitStuffing::destuff(const QByteArray &wire, qint64 *bitCount)
+{
+    const uchar *source = reinterpret_cast<const uchar *>(wire.constData());
+    if (wire.size() < 2 || source[0] != FLAG) {
+        QByteArray payload;
+        finishPayload(payload, -1, bitCount);
+        return payload;
+    }
+
+    QByteArray payload(wire.size(), Qt::Uninitialized);
+    BitWriter writer(reinterpret_cast<uchar *>(payload.data()));
+    int ones = 0;
+    qint64 bits = -1;
+    for (qsizetype i = 1; i < wire.size(); ++i) {
+        const DestuffStep &step = DESTUFF_TABLE[ones][source[i]];
+        if (step.flag) {
+            // Once per frame: find the flag's exact position bit by bit
+            bits = destuffToFlag(source, qint64(wire.size()) * 8, qint64(i) * 8, writer, ones);
+            break;
+        }
+        writer.write(step.bits, step.length);
+        ones = step.ones;
+    }
+    writer.flush();
+    finishPayload(payload, bits, bitCount);
+    return payload;
+}
+
+qint64 BitStuffing::stuffedBitCount(const QByteArray &data, qint64 bitCount)
+{
+    const qint64 bits = clampBits(data, bitCount);
+    const uchar *source = reinterpret_cast<const uchar *>(data.constData());
+    qint64 stuffed = 0;
+    int ones = 0;
+    const qint64 fullBytes = bits / 8;
+    for (qint64 i = 0; i < fullBytes; ++i) {
+        const StuffStep &step = STUFF_TABLE[ones][source[i]];
+        stuffed += step.length;
+        ones = step.ones;
+    }
+    for (qint64 bit = fullBytes * 8; bit < bits; ++bit) {
+        ones = bitAt(source, bit) ? ones + 1 : 0;
+        stuffed += (ones == MAX_ONES) ? 2 : 1;
+        if (ones == MAX_ONES) {
+            ones = 0;
+        }
+    }
+    return stuffed;
+}
+
+QByteArray BitStuffing::stuffReference(const QByteArray &data, qint64 bitCount)
+{
+    const qint64 bits = clampBits(data, bitCount);
+    const uchar *source = reinterpret_cast<const uchar *>(data.constData());
+    QByteArray wire(stuffedCapacity(bits), Qt::Uninitialized);
+    BitWriter writer(reinterpret_cast<uchar *>(wire.data()));
+
+    writer.write(FLAG, FLAG_BITS);
+    int ones = 0;
+    for (qint64 bit = 0; bit < bits; ++bit) {
+        stuffBit(writer, bitAt(source, bit), ones);
+    }
+    writer.write(FLAG, FLAG_BITS);
+    writer.flush();
+
+    wire.resize((writer.bitCount() + 7) / 8);
+    return wire;
+}
+
+QByteArray BitStuffing::destuffReference(const QByteArray &wire, qint64 *bitCount)
+{
+    const uchar *source = reinterpret_cast<const uchar *>(wire.constData());
+    if (wire.size() < 2 || source[0] != FLAG) {
+        QByteArray payload;
+        finishPayload(payload, -1, bitCount);
+        return payload;
+    }
+
+    QByteArray payload(wire.size(), Qt::Uninitialized);
+    BitWriter writer(reinterpret_cast<uchar *>(payload.data()));
+    const qint64 bits = destuffToFlag(source, qint64(wire.size()) * 8, FLAG_BITS, writer, 0);
+    writer.flush();
+    finishPayload(payload, bits, bitCount);
+    return payload;
+}
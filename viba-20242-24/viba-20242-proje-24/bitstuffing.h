@@ -0,0 +1,37 @@
+#ifndef BITSTUFFING_H
+#define BITSTUFFING_H
+
+#include <QByteArray>
+
+// Bit-oriented HDLC framing: the payload bits go between two 01111110 flags,
+// with a 0 inserted after every run of five 1s so that a flag can never
+// appear inside a frame. Unlike byte stuffing this sends exactly the frame's
+// bits (100, not 13 bytes) and adds at most one bit in six.
+//
+// Both directions step a whole input byte at a time through tables indexed
+// by the current run of 1s and the byte, carrying the run into the next byte.
+class BitStuffing
+{
+public:
+    // Frames the first bitCount bits of data (MSB first). The wire is whole
+    // bytes: zero bits pad the last byte after the closing flag.
+    static QByteArray stuff(const QByteArray &data, qint64 bitCount);
+    // Undoes stuff(): returns the bits between the flags packed MSB first,
+    // zero-padded to a whole byte, with their number in bitCount. Returns a
+    // null array if the wire does not start with a flag, has no closing
+    // flag or holds an abort (seven 1s).
+    static QByteArray destuff(const QByteArray &wire, qint64 *bitCount = nullptr);
+    // Payload bits on the wire once stuffed, flags not included
+    static qint64 stuffedBitCount(const QByteArray &data, qint64 bitCount);
+
+    // Bit-at-a-time implementations, kept as the reference for the tables
+    static QByteArray stuffReference(const QByteArray &data, qint64 bitCount);
+    static QByteArray destuffReference(const QByteArray &wire, qint64 *bitCount = nullptr);
+
+    static const uchar FLAG = 0x7E;
+    static const int FLAG_BITS = 8;
+    // Consecutive 1s after which a 0 is inserted
+    static const int MAX_ONES = 5;
+};
+
+#endif // BITSTUFFING_H
@@ -0,0 +1,90 @@
+#include "burstchannel.h"
+#include <cmath>
+
+BurstChannel::BurstChannel()
+    : BurstChannel(Parameters())
+{
+}
+
+BurstChannel::BurstChannel(const Parameters &parameters)
+    : params(parameters)
+    , bad(false)
+    , bitsToTransition(NEVER)
+    , bitsToError(NEVER)
+{
+    logStay[0] = std::log1p(-qBound(0.0, params.goodToBad, 1.0));
+    logStay[1] = std::log1p(-qBound(0.0, params.badToGood, 1.0));
+    logNoError[0] = std::log1p(-qBound(0.0, params.goodBitErrorRate, 1.0));
+    logNoError[1] = std::log1p(-qBound(0.0, params.badBitErrorRate, 1.0));
+}
+
+void BurstChannel::reset(ChannelRng &rng)
+{
+    enterState(false, rng);
+}
+
+qint64 BurstChannel::transmit(uchar *data, qint64 bitCount, ChannelRng &rng)
+{
+    qint64 flipped = 0;
+    qint64 position = 0;
+    while (position < bitCount) {
+        const qint64 span = qMin(bitsToTransition, bitCount - position);
+        if (bitsToError < span) {
+            position += bitsToError;
+            data[position >> 3] ^= static_cast<uchar>(0x80u >> (position & 7));
+            flipped++;
+            position++;
+            bitsToTransition -= bitsToError + 1;
+            bitsToError = geometricGap(logNoError[bad], rng);
+        } else {
+            position += span;
+            bitsToTransition -= span;
+            bitsToError -= span;
+        }
+        if (bitsToTransition == 0) {
+            enterState(!bad, rng);
+        }
+    }
+    return flipped;
+}
+
+const BurstChannel::Parameters &BurstChannel::parameters() const
+{
+    return params;
+}
+
+bool BurstChannel::isBad() const
+{
+    return bad;
+}
+
+double BurstChannel::badStateShare() const
+{
+    const double total = params.goodToBad + params.badToGood;
+    return total > 0.0 ? params.goodToBad / total : 0.0;
+}
+
+double BurstChannel::meanBitErrorRate() const
+{
+    const double share = badStateShare();
+    return (1.0 - share) * params.goodBitErrorRate + share * params.badBitErrorRate;
+}
+
+qint64 BurstChannel::geometricGap(double logComplement, ChannelRng &rng)
+{
+    // Number of failures before the first success of a Bernoulli(p) trial,
+    // by inversion: floor(log(U) / log(1 - p)) with U in (0, 1]
+    if (logComplement == 0.0) {
+        return NEVER;
+    }
+    const double gap = std::floor(std::log(1.0 - rng.nextDouble()) / logComplement);
+    return gap < double(NEVER) ? static_cast<qint64>(gap) : NEVER;
+}
+
+void BurstChannel::enterState(bool badState, ChannelRng &rng)
+{
+    // Both gaps are memoryless, so they can be drawn afresh on every change
+    bad = badState;
+    bitsToTransition = 1 + geometricGap(logStay[bad], rng);
+    bitsToError = geometricGap(logNoError[bad], rng);
+}
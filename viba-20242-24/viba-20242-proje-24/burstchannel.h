@@ -0,0 +1,61 @@
+#ifndef BURSTCHANNEL_H
+#define BURSTCHANNEL_H
+
+#include <QtGlobal>
+#include "channelrng.h"
+
+// Gilbert-Elliott burst error channel over the bits on the wire. A two-state
+// Markov chain switches between a good and a bad state, each with its own
+// bit error rate, and errors flip real bits in the buffer passed through.
+//
+// Neither state changes nor errors are drawn per bit: the gaps to the next
+// transition and to the next flipped bit are geometric and drawn directly,
+// so the cost is proportional to the number of errors and bursts, not to
+// the number of bits. The chain carries over from one call to the next, so
+// a burst can span frames.
+class BurstChannel
+{
+public:
+    static constexpr double DEFAULT_GOOD_TO_BAD = 2e-3; // Per bit; bursts start every ~500 bits
+    static constexpr double DEFAULT_BAD_TO_GOOD = 0.1;  // Bursts last ~10 bits
+    static constexpr double DEFAULT_GOOD_BIT_ERROR_RATE = 1e-6;
+    static constexpr double DEFAULT_BAD_BIT_ERROR_RATE = 0.5;
+
+    struct Parameters {
+        double goodToBad = DEFAULT_GOOD_TO_BAD;
+        double badToGood = DEFAULT_BAD_TO_GOOD;
+        double goodBitErrorRate = DEFAULT_GOOD_BIT_ERROR_RATE;
+        double badBitErrorRate = DEFAULT_BAD_BIT_ERROR_RATE;
+    };
+
+    BurstChannel();
+    explicit BurstChannel(const Parameters &parameters);
+
+    // Starts over in the good state
+    void reset(ChannelRng &rng);
+    // Sends the first bitCount bits of data (MSB first) through the channel,
+    // flipping bits in place. Returns the number of bits flipped.
+    qint64 transmit(uchar *data, qint64 bitCount, ChannelRng &rng);
+
+    const Parameters &parameters() const;
+    bool isBad() const;
+    // Long-run share of bits sent in the bad state, and the mean bit error rate
+    double badStateShare() const;
+    double meanBitErrorRate() const;
+
+private:
+    // Gap that never ends, for probabilities of zero; far from overflowing
+    static constexpr qint64 NEVER = qint64(1) << 60;
+
+    static qint64 geometricGap(double logComplement, ChannelRng &rng);
+    void enterState(bool badState, ChannelRng &rng);
+
+    Parameters params;
+    double logStay[2];    // log(1 - transition probability), good then bad
+    double logNoError[2]; // log(1 - bit error rate), good then bad
+    bool bad;
+    qint64 bitsToTransition; // Bits left in the current state
+    qint64 bitsToError;      // Error-free bits before the next flipped bit
+};
+
+#endif // BURSTCHANNEL_H
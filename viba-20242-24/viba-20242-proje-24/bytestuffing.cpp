@@ -0,0 +1,451 @@
+#include "bytestuffing.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define STUFFING_HAVE_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define STUFFING_AVX2_TARGET
+#else
+#define STUFFING_AVX2_TARGET __attribute__((target("avx2,popcnt,bmi")))
+#endif
+#endif
+
+namespace {
+
+const uchar FLAG = FRAME_FLAG;
+const uchar ESCAPE = ESCAPE_CHAR;
+const uchar ESCAPE_XOR = 0x20;
+
+inline int lowestBit(quint32 mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+inline int popCount(quint32 mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<int>(__popcnt(mask));
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+// Blocks with more matches than this are escaped byte by byte without
+// branches; sparser ones copy the clean runs between matches
+const int SPARSE_MATCHES = 2;
+
+// Writes up to one byte past the stuffed block
+inline uchar *stuffDense(const uchar *data, int length, uchar *out)
+{
+    for (int k = 0; k < length; ++k) {
+        const uchar ch = data[k];
+        const int special = (ch == FLAG) | (ch == ESCAPE);
+        out[0] = ch ^ (-special & (ch ^ ESCAPE));
+        out[1] = ch ^ ESCAPE_XOR;
+        out += 1 + special;
+    }
+    return out;
+}
+
+// Decodes whole escape pairs from data and returns how many bytes it used.
+// A trailing escape is left for the next block; returns -1 at an escaped
+// ESCAPE_CHAR. Writes up to one byte past the decoded output.
+inline int destuffDense(const uchar *data, int length, uchar *&out)
+{
+    int escaped = 0;
+    for (int k = 0; k < length; ++k) {
+        const uchar ch = data[k];
+        const int isEscape = ch == ESCAPE;
+        if (escaped & isEscape) {
+            return -1;
+        }
+        *out = ch ^ (-escaped & ESCAPE_XOR);
+        escaped = isEscape;
+        out += 1 - escaped;
+    }
+    return escaped ? length - 1 : length;
+}
+
+#ifdef STUFFING_HAVE_SIMD
+// Bit i is set when data[i] equals first or second (SSE2 is part of x86-64)
+inline quint32 matchMask16(const uchar *data, __m128i first, __m128i second)
+{
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second));
+    return static_cast<quint32>(_mm_movemask_epi8(hits));
+}
+
+STUFFING_AVX2_TARGET inline quint32 matchMask32(const uchar *data, __m256i first, __m256i second)
+{
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    const __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, first), _mm256_cmpeq_epi8(block, second));
+    return static_cast<quint32>(_mm256_movemask_epi8(hits));
+}
+
+STUFFING_AVX2_TARGET qsizetype countBytesAvx2(const uchar *data, qsizetype length, uchar first, uchar second)
+{
+    const __m256i a = _mm256_set1_epi8(static_cast<char>(first));
+    const __m256i b = _mm256_set1_epi8(static_cast<char>(second));
+    qsizetype count = 0;
+    qsizetype i = 0;
+    for (; i + 32 <= length; i += 32) {
+        count += _mm_popcnt_u32(matchMask32(data + i, a, b));
+    }
+    for (; i < length; ++i) {
+        count += (data[i] == first || data[i] == second);
+    }
+    return count;
+}
+
+qsizetype countBytesSse2(const uchar *data, qsizetype length, uchar first, uchar second)
+{
+    const __m128i a = _mm_set1_epi8(static_cast<char>(first));
+    const __m128i b = _mm_set1_epi8(static_cast<char>(second));
+    qsizetype count = 0;
+    qsizetype i = 0;
+    for (; i + 16 <= length; i += 16) {
+        count += popCount(matchMask16(data + i, a, b));
+    }
+    for (; i < length; ++i) {
+        count += (data[i] == first || data[i] == second);
+    }
+    return count;
+}
+
+// Copies the clean bytes of each block in bulk and escapes the matches in it
+STUFFING_AVX2_TARGET uchar *stuffAvx2(const uchar *data, qsizetype length, uchar *out, qsizetype &done)
+{
+    const __m256i flag = _mm256_set1_epi8(static_cast<char>(FLAG));
+    const __m256i escape = _mm256_set1_epi8(static_cast<char>(ESCAPE));
+    qsizetype i = 0;
+    for (; i + 32 <= length; i += 32) {
+        quint32 mask = matchMask32(data + i, flag, escape);
+        if (!mask) {
+            memcpy(out, data + i, 32);
+            out += 32;
+            continue;
+        }
+        if (_mm_popcnt_u32(mask) > SPARSE_MATCHES) {
+            out = stuffDense(data + i, 32, out);
+            continue;
+        }
+        int start = 0;
+        while (mask) {
+            const int pos = lowestBit(mask);
+            memcpy(out, data + i + start, pos - start);
+            out += pos - start;
+            *out++ = ESCAPE;
+            *out++ = data[i + pos] ^ ESCAPE_XOR;
+            start = pos + 1;
+            mask &= mask - 1;
+        }
+        memcpy(out, data + i + start, 32 - start);
+        out += 32 - start;
+    }
+    done = i;
+    return out;
+}
+
+uchar *stuffSse2(const uchar *data, qsizetype length, uchar *out, qsizetype &done)
+{
+    const __m128i flag = _mm_set1_epi8(static_cast<char>(FLAG));
+    const __m128i escape = _mm_set1_epi8(static_cast<char>(ESCAPE));
+    qsizetype i = 0;
+    for (; i + 16 <= length; i += 16) {
+        quint32 mask = matchMask16(data + i, flag, escape);
+        if (!mask) {
+            memcpy(out, data + i, 16);
+            out += 16;
+            continue;
+        }
+        if (popCount(mask) > SPARSE_MATCHES) {
+            out = stuffDense(data + i, 16, out);
+            continue;
+        }
+        int start = 0;
+        while (mask) {
+            const int pos = lowestBit(mask);
+            memcpy(out, data + i + start, pos - start);
+            out += pos - start;
+            *out++ = ESCAPE;
+            *out++ = data[i + pos] ^ ESCAPE_XOR;
+            start = pos + 1;
+            mask &= mask - 1;
+        }
+        memcpy(out, data + i + start, 16 - start);
+        out += 16 - start;
+    }
+    done = i;
+    return out;
+}
+
+// Copies up to the next escape, then decodes it together with the byte after
+// it, which may sit in the next block. Stops at an escaped ESCAPE_CHAR, which
+// stuff() never produces, and leaves it to the caller.
+STUFFING_AVX2_TARGET uchar *destuffAvx2(const uchar *data, qsizetype length, uchar *out, qsizetype &done)
+{
+    const __m256i escape = _mm256_set1_epi8(static_cast<char>(ESCAPE));
+    qsizetype i = 0;
+    while (i + 32 <= length) {
+        const quint32 mask = matchMask32(data + i, escape, escape);
+        if (!mask) {
+            memcpy(out, data + i, 32);
+            out += 32;
+            i += 32;
+            continue;
+        }
+        if (_mm_popcnt_u32(mask) > SPARSE_MATCHES) {
+            uchar *blockOut = out;
+            const int used = destuffDense(data + i, 32, blockOut);
+            if (used < 0) {
+                break;
+            }
+            out = blockOut;
+            i += used;
+            continue;
+        }
+        const int pos = lowestBit(mask);
+        memcpy(out, data + i, pos);
+        out += pos;
+        i += pos;
+        if (i + 1 >= length || data[i + 1] == ESCAPE) {
+            break;
+        }
+        *out++ = data[i + 1] ^ ESCAPE_XOR;
+        i += 2;
+    }
+    done = i;
+    return out;
+}
+
+uchar *destuffSse2(const uchar *data, qsizetype length, uchar *out, qsizetype &done)
+{
+    const __m128i escape = _mm_set1_epi8(static_cast<char>(ESCAPE));
+    qsizetype i = 0;
+    while (i + 16 <= length) {
+        const quint32 mask = matchMask16(data + i, escape, escape);
+        if (!mask) {
+            memcpy(out, data + i, 16);
+            out += 16;
+            i += 16;
+            continue;
+        }
+        if (popCount(mask) > SPARSE_MATCHES) {
+            uchar *blockOut = out;
+            const int used = destuffDense(data + i, 16, blockOut);
+            if (used < 0) {
+                break;
+            }
+            out = blockOut;
+            i += used;
+            continue;
+        }
+        const int pos = lowestBit(mask);
+        memcpy(out, data + i, pos);
+        out += pos;
+        i += pos;
+        if (i + 1 >= length || data[i + 1] == ESCAPE) {
+            break;
+        }
+        *out++ = data[i + 1] ^ ESCAPE_XOR;
+        i += 2;
+    }
+    done = i;
+    return out;
+}
+#endif
+
+}
+
+QByteArray ByteStuffing::stuff(const QByteArray &data)
+{
+    const uchar *source = reinterpret_cast<const uchar *>(data.constData());
+    QByteArray stuffed(stuffedSize(data), Qt::Uninitialized);
+    uchar *out = reinterpret_cast<uchar *>(stuffed.data());
+
+    *out++ = FLAG; // Start flag
+    out = stuffInto(source, data.size(), out); // May overrun into the end flag's slot
+    *out = FLAG; // End flag
+    return stuffed;
+}
+
+QByteArray ByteStuffing::destuff(const QByteArray &stuffedData)
+{
+    // Skip the start and end flags
+    const qsizetype length = qMax<qsizetype>(0, stuffedData.size() - 2);
+    if (length == 0) {
+        return QByteArray();
+    }
+    const uchar *source = reinterpret_cast<const uchar *>(stuffedData.constData()) + 1;
+
+    // Every escape removes exactly one byte from well-formed input; one spare
+    // byte absorbs the overrun of the dense path
+    const qsizetype size = length - countBytes(source, length, ESCAPE, ESCAPE);
+    QByteArray destuffed(size + 1, Qt::Uninitialized);
+    uchar *out = reinterpret_cast<uchar *>(destuffed.data());
+    if (!destuffInto(source, length, out, out + size)) {
+        // An escaped ESCAPE_CHAR breaks the count; decode it the slow way
+        return destuffReference(stuffedData);
+    }
+    destuffed.resize(size);
+    return destuffed;
+}
+
+qsizetype ByteStuffing::stuffedSize(const QByteArray &data)
+{
+    const uchar *source = reinterpret_cast<const uchar *>(data.constData());
+    return data.size() + countBytes(source, data.size(), FLAG, ESCAPE) + 2;
+}
+
+qsizetype ByteStuffing::destuffSpan(const uchar *data, qsizetype length, uchar *out, bool &escaped)
+{
+    uchar *const start = out;
+    qsizetype i = 0;
+    if (escaped && length > 0) {
+        *out++ = data[0] ^ ESCAPE_XOR;
+        escaped = false;
+        i = 1;
+    }
+    while (i < length) {
+#ifdef STUFFING_HAVE_SIMD
+        qsizetype done = 0;
+        out = avx2Supported() ? destuffAvx2(data + i, length - i, out, done)
+                              : destuffSse2(data + i, length - i, out, done);
+        i += done;
+        if (i >= length) {
+            break;
+        }
+#endif
+        // One step past what the vector path stopped at: the short tail, a
+        // trailing escape or an escaped ESCAPE_CHAR
+        if (data[i] != ESCAPE) {
+            *out++ = data[i++];
+        } else if (i + 1 >= length) {
+            escaped = true;
+            ++i;
+        } else {
+            *out++ = data[i + 1] ^ ESCAPE_XOR;
+            i += 2;
+        }
+    }
+    return out - start;
+}
+
+QByteArray ByteStuffing::stuffReference(const QByteArray &data)
+{
+    QByteArray stuffed;
+    stuffed.append(FRAME_FLAG); // Start flag
+
+    for (const char &ch : data) {
+        if (ch == FRAME_FLAG || ch == ESCAPE_CHAR) {
+            stuffed.append(ESCAPE_CHAR);
+            stuffed.append(ch ^ 0x20); // XOR with 0x20 to transform the character
+        } else {
+            stuffed.append(ch);
+        }
+    }
+
+    stuffed.append(FRAME_FLAG); // End flag
+    return stuffed;
+}
+
+QByteArray ByteStuffing::destuffReference(const QByteArray &stuffedData)
+{
+    QByteArray destuffed;
+    bool escaped = false;
+
+    // Skip the start flag
+    for (int i = 1; i < stuffedData.size() - 1; i++) {
+        char ch = stuffedData[i];
+
+        if (escaped) {
+            destuffed.append(ch ^ 0x20); // Reverse the XOR transformation
+            escaped = false;
+        } else if (ch == ESCAPE_CHAR) {
+            escaped = true;
+        } else {
+            destuffed.append(ch);
+        }
+    }
+
+    return destuffed;
+}
+
+qsizetype ByteStuffing::countBytes(const uchar *data, qsizetype length, uchar first, uchar second)
+{
+#ifdef STUFFING_HAVE_SIMD
+    return avx2Supported() ? countBytesAvx2(data, length, first, second)
+                           : countBytesSse2(data, length, first, second);
+#else
+    qsizetype count = 0;
+    for (qsizetype i = 0; i < length; ++i) {
+        count += (data[i] == first || data[i] == second);
+    }
+    return count;
+#endif
+}
+
+uchar *ByteStuffing::stuffInto(const uchar *data, qsizetype length, uchar *out)
+{
+    qsizetype i = 0;
+#ifdef STUFFING_HAVE_SIMD
+    out = avx2Supported() ? stuffAvx2(data, length, out, i) : stuffSse2(data, length, out, i);
+#endif
+    for (; i < length; ++i) {
+        if (data[i] == FLAG || data[i] == ESCAPE) {
+            *out++ = ESCAPE;
+            *out++ = data[i] ^ ESCAPE_XOR;
+        } else {
+            *out++ = data[i];
+        }
+    }
+    return out;
+}
+
+uchar *ByteStuffing::destuffInto(const uchar *data, qsizetype length, uchar *out, uchar *outEnd)
+{
+    qsizetype i = 0;
+#ifdef STUFFING_HAVE_SIMD
+    out = avx2Supported() ? destuffAvx2(data, length, out, i) : destuffSse2(data, length, out, i);
+#endif
+    while (i < length) {
+        if (data[i] != ESCAPE) {
+            *out++ = data[i++];
+        } else if (i + 1 >= length) {
+            break; // Dangling escape before the end flag
+        } else if (data[i + 1] == ESCAPE) {
+            return nullptr;
+        } else {
+            *out++ = data[i + 1] ^ ESCAPE_XOR;
+            i += 2;
+        }
+    }
+    return out == outEnd ? out : nullptr;
+}
+
+bool ByteStuffing::avx2Supported()
+{
+    // Resolved once on first use from cpuid
+    static const bool supported = []() {
+#if defined(STUFFING_HAVE_SIMD) && defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0 && (info[1] & (1 << 3)) != 0;
+#elif defined(STUFFING_HAVE_SIMD)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")
+            && __builtin_cpu_supports("bmi");
+#else
+        return false;
+#endif
+    }();
+    return supported;
+}
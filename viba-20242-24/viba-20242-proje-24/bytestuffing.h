@@ -0,0 +1,39 @@
+#ifndef BYTESTUFFING_H
+#define BYTESTUFFING_H
+
+#include <QByteArray>
+
+// Frame flags and escape character definitions
+#define FRAME_FLAG 0x7E
+#define ESCAPE_CHAR 0x7D
+
+// Flag-delimited byte stuffing as sent on the simulated wire: FRAME_FLAG and
+// ESCAPE_CHAR inside the payload become ESCAPE_CHAR followed by the byte XOR 0x20.
+// Payloads are scanned 32 (AVX2) or 16 (SSE2) bytes at a time and clean runs
+// are copied in bulk; the output is sized up front from a count of the matches.
+class ByteStuffing
+{
+public:
+    static QByteArray stuff(const QByteArray &data);
+    // Expects one frame with a flag at each end, as produced by stuff()
+    static QByteArray destuff(const QByteArray &stuffedData);
+    // Size of data on the wire, flags included, without building it
+    static qsizetype stuffedSize(const QByteArray &data);
+    // Decodes length bytes of a stuffed stream that contain no flag. escaped
+    // carries a trailing escape over to the next span. out must hold
+    // length + 1 bytes; returns the number of bytes written.
+    static qsizetype destuffSpan(const uchar *data, qsizetype length, uchar *out, bool &escaped);
+
+    // Byte-at-a-time implementations, kept as the reference for the SIMD paths
+    static QByteArray stuffReference(const QByteArray &data);
+    static QByteArray destuffReference(const QByteArray &stuffedData);
+
+private:
+    // Number of bytes in [data, data + length) equal to first or second
+    static qsizetype countBytes(const uchar *data, qsizetype length, uchar first, uchar second);
+    static uchar *stuffInto(const uchar *data, qsizetype length, uchar *out);
+    static uchar *destuffInto(const uchar *data, qsizetype length, uchar *out, uchar *outEnd);
+    static bool avx2Supported();
+};
+
+#endif // BYTESTUFFING_H
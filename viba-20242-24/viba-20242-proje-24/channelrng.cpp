@@ -0,0 +1,69 @@
+#include "channelrng.h"
+
+ChannelRng::ChannelRng(quint64 seed)
+{
+    this->seed(seed);
+}
+
+void ChannelRng::seed(quint64 seed)
+{
+    // SplitMix64 never yields the all-zero state xoshiro cannot leave
+    for (int i = 0; i < 4; ++i) {
+        quint64 z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+void ChannelRng::fillUniform(double *out, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        out[i] = nextDouble();
+    }
+}
+
+quint64 ChannelRng::bernoulliMask(double probability)
+{
+    const quint32 scale = 1u << BERNOULLI_PRECISION_BITS;
+    const quint32 threshold = probability <= 0.0 ? 0
+        : probability >= 1.0 ? scale : static_cast<quint32>(probability * scale + 0.5);
+    if (threshold == 0) {
+        return 0;
+    }
+    if (threshold >= scale) {
+        return ~quint64(0);
+    }
+
+    // Each lane compares its own random number U against the threshold T,
+    // one bit per draw from the least significant end: U < T holds if the
+    // higher bit decides it, otherwise what the lower bits decided stands.
+    // A random draw stands in for the bits of U, so a lane ends up set
+    // with probability T / scale. Bits below T's lowest set bit cannot
+    // make U < T and are skipped.
+    quint64 mask = 0;
+    int bit = 0;
+    while (!((threshold >> bit) & 1)) {
+        ++bit;
+    }
+    for (; bit < BERNOULLI_PRECISION_BITS; ++bit) {
+        if ((threshold >> bit) & 1) {
+            mask |= next();
+        } else {
+            mask &= next();
+        }
+    }
+    return mask;
+}
+
+BernoulliStream::BernoulliStream(double probability)
+    : probability(probability)
+    , bits(0)
+    , remaining(0)
+{
+}
+
+double BernoulliStream::getProbability() const
+{
+    return probability;
+}
@@ -0,0 +1,82 @@
+#ifndef CHANNELRNG_H
+#define CHANNELRNG_H
+
+#include <QtGlobal>
+
+// xoshiro256** generator for the simulated channel. Every run or trial owns
+// its own instance, seeded explicitly, so results are reproducible and no
+// thread shares or locks a generator. Not for cryptographic use.
+class ChannelRng
+{
+public:
+    // Precision of the probabilities bernoulliMask() works with
+    static const int BERNOULLI_PRECISION_BITS = 16;
+
+    explicit ChannelRng(quint64 seed = 0);
+
+    // Expands seed into the 256-bit state with SplitMix64
+    void seed(quint64 seed);
+
+    quint64 next()
+    {
+        const quint64 result = rotl(state[1] * 5, 7) * 9;
+        const quint64 t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1) with 53 random bits
+    double nextDouble()
+    {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    void fillUniform(double *out, qsizetype count);
+
+    // 64 independent Bernoulli(probability) draws, one per bit. The
+    // probability is rounded to BERNOULLI_PRECISION_BITS bits, and a mask
+    // costs at most that many 64-bit draws, often fewer.
+    quint64 bernoulliMask(double probability);
+
+private:
+    static quint64 rotl(quint64 x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    quint64 state[4];
+};
+
+// Yes/no outcomes with a fixed probability, taken one at a time from
+// 64-outcome Bernoulli masks of the generator passed in
+class BernoulliStream
+{
+public:
+    explicit BernoulliStream(double probability = 0.0);
+
+    bool next(ChannelRng &rng)
+    {
+        if (remaining == 0) {
+            bits = rng.bernoulliMask(probability);
+            remaining = 64;
+        }
+        const bool result = bits & 1;
+        bits >>= 1;
+        --remaining;
+        return result;
+    }
+
+    double getProbability() const;
+
+private:
+    double probability;
+    quint64 bits;
+    int remaining;
+};
+
+#endif // CHANNELRNG_H
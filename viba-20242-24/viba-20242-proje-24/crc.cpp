@@ -1,9 +1,85 @@
 #include "crc.h"
+#include "frame.h"
 #include <QByteArray>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRC_HAVE_CLMUL 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CRC_CLMUL_TARGET
+#else
+#define CRC_CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+#endif
+#endif
+
+namespace {
+
+constexpr CRC::Tables CRC_TABLES = CRC::makeTables(CRC::POLYNOMIAL);
+
+// x^n mod P, used as folding constants by the carry-less multiply path
+constexpr quint64 xPowModP(int n, quint16 polynomial)
+{
+    quint32 r = 1;
+    for (int i = 0; i < n; ++i) {
+        r <<= 1;
+        if (r & 0x10000) {
+            r ^= 0x10000u | polynomial;
+        }
+    }
+    return r;
+}
+
+} // namespace
+
+#ifdef CRC_HAVE_CLMUL
+namespace {
+
+// Folding a 128-bit remainder X forward by n bits: X * x^n is split into
+// hi64 * x^(n+64) + lo64 * x^n, each reduced constant being only 16 bits wide.
+struct FoldConstants
+{
+    quint64 hi;
+    quint64 lo;
+};
+
+constexpr FoldConstants foldConstants(int bits)
+{
+    return { xPowModP(bits + 64, 0x1021), xPowModP(bits, 0x1021) };
+}
+
+constexpr FoldConstants FOLD_128 = foldConstants(128);
+constexpr FoldConstants FOLD_256 = foldConstants(256);
+constexpr FoldConstants FOLD_384 = foldConstants(384);
+constexpr FoldConstants FOLD_512 = foldConstants(512);
+
+CRC_CLMUL_TARGET inline __m128i loadBigEndian(const uchar *data)
+{
+    const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), reverse);
+}
+
+CRC_CLMUL_TARGET inline __m128i fold(__m128i x, __m128i constants)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, constants, 0x11),
+                         _mm_clmulepi64_si128(x, constants, 0x00));
+}
+
+CRC_CLMUL_TARGET inline __m128i constantsVector(const FoldConstants &k)
+{
+    return _mm_set_epi64x(static_cast<long long>(k.hi), static_cast<long long>(k.lo));
+}
+
+} // namespace
+#endif
+
 QString CRC::calculateCRC16(const QByteArray &data)
 {
-    quint16 crc = calculateCRC16Internal(data);
+    return formatCRC16(calculateCRC16Internal(data));
+}
+
+QString CRC::formatCRC16(quint16 crc)
+{
     return QString("%1").arg(crc, 4, 16, QChar('0')).toUpper();
 }
 
@@ -15,14 +91,89 @@ bool CRC::verifyCRC16(const QByteArray &data, const QString &crc)
     return ok && (calculatedCRC == expectedCRC);
 }
 
-quint16 CRC::calculateCRC16Internal(const QByteArray &data)
+bool CRC::verifyCRC16(const QByteArray &data, quint16 crc)
+{
+    return calculateCRC16Internal(data) == crc;
+}
+
+void CRC::calculateBatch(const Frame *frames, qsizetype count, quint16 *out)
+{
+    qsizetype i = 0;
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        const qsizetype length = frames[i].getDataSize();
+        const uchar *lanes[BATCH_LANES];
+        bool uniform = true;
+        for (int l = 0; l < BATCH_LANES; ++l) {
+            lanes[l] = reinterpret_cast<const uchar *>(frames[i + l].getConstData());
+            uniform = uniform && frames[i + l].getDataSize() == length;
+        }
+
+        if (uniform) {
+            updateCRC16Lanes(out + i, lanes, length);
+            for (int l = 0; l < BATCH_LANES; ++l) {
+                out[i + l] = static_cast<quint16>(out[i + l] ^ FINAL_XOR_VALUE);
+            }
+        } else {
+            for (int l = 0; l < BATCH_LANES; ++l) {
+                out[i + l] = static_cast<quint16>(
+                    updateCRC16(INITIAL_VALUE, lanes[l], frames[i + l].getDataSize()) ^ FINAL_XOR_VALUE);
+            }
+        }
+    }
+
+    for (; i < count; ++i) {
+        const uchar *bytes = reinterpret_cast<const uchar *>(frames[i].getConstData());
+        out[i] = static_cast<quint16>(updateCRC16(INITIAL_VALUE, bytes, frames[i].getDataSize()) ^ FINAL_XOR_VALUE);
+    }
+}
+
+QVector<quint16> CRC::calculateBatch(const QVector<Frame> &frames)
+{
+    QVector<quint16> result(frames.size());
+    calculateBatch(frames.constData(), frames.size(), result.data());
+    return result;
+}
+
+void CRC::calculateBatch(const uchar *payloads, qsizetype stride, qsizetype length,
+                         qsizetype count, quint16 *out)
+{
+    qsizetype i = 0;
+    for (; i + BATCH_LANES <= count; i += BATCH_LANES) {
+        const uchar *lanes[BATCH_LANES];
+        for (int l = 0; l < BATCH_LANES; ++l) {
+            lanes[l] = payloads + (i + l) * stride;
+        }
+        updateCRC16Lanes(out + i, lanes, length);
+        for (int l = 0; l < BATCH_LANES; ++l) {
+            out[i + l] = static_cast<quint16>(out[i + l] ^ FINAL_XOR_VALUE);
+        }
+    }
+
+    for (; i < count; ++i) {
+        out[i] = static_cast<quint16>(updateCRC16(INITIAL_VALUE, payloads + i * stride, length) ^ FINAL_XOR_VALUE);
+    }
+}
+
+QVector<int> CRC::verifyBatch(const QVector<Frame> &frames)
+{
+    const QVector<quint16> calculated = calculateBatch(frames);
+    QVector<int> mismatches;
+    for (int i = 0; i < frames.size(); ++i) {
+        if (calculated[i] != frames[i].getCRCValue()) {
+            mismatches.append(i);
+        }
+    }
+    return mismatches;
+}
+
+quint16 CRC::calculateCRC16Reference(const QByteArray &data)
 {
     quint32 crc = INITIAL_VALUE;
 
     for (const char &ch : data) {
         quint8 byte = static_cast<quint8>(ch);
         crc ^= (static_cast<quint32>(byte) << 8);
-        
+
         for (int i = 0; i < 8; i++) {
             if (crc & 0x8000) {
                 crc = (crc << 1) ^ POLYNOMIAL;
@@ -34,3 +185,142 @@ quint16 CRC::calculateCRC16Internal(const QByteArray &data)
 
     return static_cast<quint16>(crc ^ FINAL_XOR_VALUE);
 }
+
+quint16 CRC::calculateCRC16Internal(const QByteArray &data)
+{
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    return static_cast<quint16>(updateCRC16(INITIAL_VALUE, bytes, data.size()) ^ FINAL_XOR_VALUE);
+}
+
+quint16 CRC::updateCRC16(quint16 crc, const uchar *data, qsizetype length)
+{
+    if (length >= CLMUL_THRESHOLD && clmulSupported()) {
+        return updateCRC16Clmul(crc, data, length);
+    }
+    return updateCRC16Table(crc, data, length);
+}
+
+bool CRC::clmulSupported()
+{
+    // Resolved once on first use from cpuid: PCLMULQDQ plus SSSE3 for the byte shuffle
+    static const bool supported = []() {
+#if defined(CRC_HAVE_CLMUL) && defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 1)) != 0 && (info[2] & (1 << 9)) != 0;
+#elif defined(CRC_HAVE_CLMUL)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+#else
+        return false;
+#endif
+    }();
+    return supported;
+}
+
+#ifdef CRC_HAVE_CLMUL
+CRC_CLMUL_TARGET quint16 CRC::updateCRC16Clmul(quint16 crc, const uchar *data, qsizetype length)
+{
+    // Fold the buffer into a 128-bit value congruent to it modulo P, then let
+    // the table engine reduce those 16 bytes together with the unaligned tail.
+    __m128i x0 = loadBigEndian(data);
+    x0 = _mm_xor_si128(x0, _mm_set_epi64x(static_cast<long long>(static_cast<quint64>(crc) << 48), 0));
+    data += 16;
+    length -= 16;
+
+    if (length >= 48) {
+        __m128i x1 = loadBigEndian(data);
+        __m128i x2 = loadBigEndian(data + 16);
+        __m128i x3 = loadBigEndian(data + 32);
+        data += 48;
+        length -= 48;
+
+        const __m128i k512 = constantsVector(FOLD_512);
+        while (length >= 64) {
+            x0 = _mm_xor_si128(fold(x0, k512), loadBigEndian(data));
+            x1 = _mm_xor_si128(fold(x1, k512), loadBigEndian(data + 16));
+            x2 = _mm_xor_si128(fold(x2, k512), loadBigEndian(data + 32));
+            x3 = _mm_xor_si128(fold(x3, k512), loadBigEndian(data + 48));
+            data += 64;
+            length -= 64;
+        }
+
+        x0 = _mm_xor_si128(_mm_xor_si128(fold(x0, constantsVector(FOLD_384)),
+                                         fold(x1, constantsVector(FOLD_256))),
+                           _mm_xor_si128(fold(x2, constantsVector(FOLD_128)), x3));
+    }
+
+    const __m128i k128 = constantsVector(FOLD_128);
+    while (length >= 16) {
+        x0 = _mm_xor_si128(fold(x0, k128), loadBigEndian(data));
+        data += 16;
+        length -= 16;
+    }
+
+    alignas(16) uchar remainder[16];
+    const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    _mm_store_si128(reinterpret_cast<__m128i *>(remainder), _mm_shuffle_epi8(x0, reverse));
+
+    return updateCRC16Table(updateCRC16Table(0, remainder, 16), data, length);
+}
+#else
+quint16 CRC::updateCRC16Clmul(quint16 crc, const uchar *data, qsizetype length)
+{
+    return updateCRC16Table(crc, data, length);
+}
+#endif
+
+void CRC::updateCRC16Lanes(quint16 *crcs, const uchar *const *lanes, qsizetype length)
+{
+    // BATCH_LANES independent dependency chains per step, so the table loads
+    // of one frame overlap with those of the others.
+    quint16 crc[BATCH_LANES];
+    for (int l = 0; l < BATCH_LANES; ++l) {
+        crc[l] = INITIAL_VALUE;
+    }
+
+    qsizetype pos = 0;
+    for (; pos + 8 <= length; pos += 8) {
+        for (int l = 0; l < BATCH_LANES; ++l) {
+            const uchar *data = lanes[l] + pos;
+            const quint16 head = static_cast<quint16>(crc[l] ^ ((data[0] << 8) | data[1]));
+            crc[l] = static_cast<quint16>(CRC_TABLES[7][head >> 8] ^ CRC_TABLES[6][head & 0xFF]
+                                          ^ CRC_TABLES[5][data[2]] ^ CRC_TABLES[4][data[3]]
+                                          ^ CRC_TABLES[3][data[4]] ^ CRC_TABLES[2][data[5]]
+                                          ^ CRC_TABLES[1][data[6]] ^ CRC_TABLES[0][data[7]]);
+        }
+    }
+
+    for (; pos < length; ++pos) {
+        for (int l = 0; l < BATCH_LANES; ++l) {
+            crc[l] = static_cast<quint16>((crc[l] << 8) ^ CRC_TABLES[0][(crc[l] >> 8) ^ lanes[l][pos]]);
+        }
+    }
+
+    for (int l = 0; l < BATCH_LANES; ++l) {
+        crcs[l] = crc[l];
+    }
+}
+
+quint16 CRC::updateCRC16Table(quint16 crc, const uchar *data, qsizetype length)
+{
+    static_assert(POLYNOMIAL == 0x1021, "CRC_TABLES must be generated for POLYNOMIAL");
+
+    // Eight bytes per step: the running CRC is folded into the first two bytes
+    // and every byte is looked up in the table matching its distance to the end.
+    while (length >= 8) {
+        const quint16 head = static_cast<quint16>(crc ^ ((data[0] << 8) | data[1]));
+        crc = static_cast<quint16>(CRC_TABLES[7][head >> 8] ^ CRC_TABLES[6][head & 0xFF]
+                                   ^ CRC_TABLES[5][data[2]] ^ CRC_TABLES[4][data[3]]
+                                   ^ CRC_TABLES[3][data[4]] ^ CRC_TABLES[2][data[5]]
+                                   ^ CRC_TABLES[1][data[6]] ^ CRC_TABLES[0][data[7]]);
+        data += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0) {
+        crc = static_cast<quint16>((crc << 8) ^ CRC_TABLES[0][(crc >> 8) ^ *data++]);
+    }
+
+    return crc;
+}
@@ -3,21 +3,73 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QVector>
+#include <array>
+
+class Frame;
 
 class CRC
 {
 public:
     static QString calculateCRC16(const QByteArray &data);
     static bool verifyCRC16(const QByteArray &data, const QString &crc);
+    static bool verifyCRC16(const QByteArray &data, quint16 crc);
+    static QString formatCRC16(quint16 crc);
+
+    // Bulk CRC of many short frames, interleaved BATCH_LANES frames at a time
+    static void calculateBatch(const Frame *frames, qsizetype count, quint16 *out);
+    static QVector<quint16> calculateBatch(const QVector<Frame> &frames);
+    // Same for count fixed-size payloads laid out every stride bytes
+    static void calculateBatch(const uchar *payloads, qsizetype stride, qsizetype length,
+                               qsizetype count, quint16 *out);
+    // Returns the positions in frames whose payload no longer matches its CRC
+    static QVector<int> verifyBatch(const QVector<Frame> &frames);
+
+    // Bit-at-a-time implementation, kept as the reference for the table engine
+    static quint16 calculateCRC16Reference(const QByteArray &data);
 
-private:
     // Doğru polinom: x^16 + x^12 + x^5 + 1
-static const quint16 POLYNOMIAL = 0x1021;
- // x¹⁶ + x¹² + x⁵ + 1
+    static const quint16 POLYNOMIAL = 0x1021;
     static const quint16 INITIAL_VALUE = 0xFFFF;
     static const quint16 FINAL_XOR_VALUE = 0x0000;
 
+    // Slicing-by-8 tables: table[0] is the classic byte table, table[k][b] is
+    // the CRC contribution of byte b followed by k zero bytes. Built at
+    // compile time for any polynomial.
+    typedef std::array<std::array<quint16, 256>, 8> Tables;
+
+    static constexpr Tables makeTables(quint16 polynomial)
+    {
+        Tables tables{};
+        for (int b = 0; b < 256; ++b) {
+            quint16 crc = static_cast<quint16>(b << 8);
+            for (int i = 0; i < 8; ++i) {
+                crc = (crc & 0x8000) ? static_cast<quint16>((crc << 1) ^ polynomial)
+                                     : static_cast<quint16>(crc << 1);
+            }
+            tables[0][b] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int b = 0; b < 256; ++b) {
+                const quint16 prev = tables[k - 1][b];
+                tables[k][b] = static_cast<quint16>((prev << 8) ^ tables[0][prev >> 8]);
+            }
+        }
+        return tables;
+    }
+
+private:
+    // Buffers at least this long go through the carry-less multiply path
+    static const qsizetype CLMUL_THRESHOLD = 256;
+    // Independent CRC chains kept in flight by calculateBatch
+    static const int BATCH_LANES = 8;
+
     static quint16 calculateCRC16Internal(const QByteArray &data);
+    static quint16 updateCRC16(quint16 crc, const uchar *data, qsizetype length);
+    static quint16 updateCRC16Table(quint16 crc, const uchar *data, qsizetype length);
+    static quint16 updateCRC16Clmul(quint16 crc, const uchar *data, qsizetype length);
+    static void updateCRC16Lanes(quint16 *crcs, const uchar *const *lanes, qsizetype length);
+    static bool clmulSupported();
 };
 
-#endif // CRC_H 
\ No newline at end of file
+#endif // CRC_H
@@ -0,0 +1,578 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+#include "bitpacker.h"
+#include "bitstuffing.h"
+#include "burstchannel.h"
+#include "bytestuffing.h"
+#include "channelrng.h"
+#include "crc.h"
+#include "datalinklayer.h"
+#include "deframer.h"
+#include "framecodec.h"
+#include "framesource.h"
+#include "framestore.h"
+
+// Microbenchmarks for every stage of the pipeline, plus file -> frames ->
+// wire end to end. Each reports bytes/s and, where frames are involved,
+// frames/s. Sizes run from 1 KB to 1 GB; stuffing is also swept over the
+// share of flag/escape bytes in the input. Save results for comparison with
+//   datalink_bench --benchmark_out=results.json --benchmark_out_format=json
+// and limit a run with --benchmark_filter=<regex>.
+
+namespace {
+
+const qint64 KB = 1024;
+const qint64 MB = 1024 * KB;
+const qint64 GB = 1024 * MB;
+
+// Payload of size bytes in which densityPercent % of the bytes are FRAME_FLAG
+// or ESCAPE_CHAR. Only the latest buffer is kept, so 1 GB inputs are built once.
+const QByteArray &testData(qint64 size, int densityPercent)
+{
+    static QByteArray cached;
+    static qint64 cachedSize = -1;
+    static int cachedDensity = -1;
+    if (size == cachedSize && densityPercent == cachedDensity) {
+        return cached;
+    }
+
+    cached = QByteArray();
+    cached.resize(size);
+    char *data = cached.data();
+    quint64 state = 0x9E3779B97F4A7C15ULL ^ quint64(size) ^ (quint64(densityPercent) << 56);
+    const quint64 threshold = quint64(densityPercent) * (~quint64(0) / 100);
+    for (qint64 i = 0; i < size; ++i) {
+        // xorshift64*: cheap and the same on every run
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        const quint64 r = state * 0x2545F4914F6CDD1DULL;
+        if (r < threshold) {
+            data[i] = (r & 1) ? char(FRAME_FLAG) : char(ESCAPE_CHAR);
+        } else {
+            char c = char(r >> 56);
+            if (c == char(FRAME_FLAG) || c == char(ESCAPE_CHAR)) {
+                c ^= 0x20;
+            }
+            data[i] = c;
+        }
+    }
+    cachedSize = size;
+    cachedDensity = densityPercent;
+    return cached;
+}
+
+// English-like text with no flag bytes, the typical payload
+QByteArray textData(qint64 size)
+{
+    static const char words[] =
+        "the quick brown fox jumps over the lazy dog while frames with a cyclic "
+        "redundancy check cross a noisy link and are acknowledged by the receiver. ";
+    QByteArray text;
+    text.reserve(size);
+    while (text.size() < size) {
+        text.append(words, qMin<qint64>(sizeof(words) - 1, size - text.size()));
+    }
+    return text;
+}
+
+void setThroughput(benchmark::State &state, qint64 bytesPerIteration, qint64 framesPerIteration = 0)
+{
+    state.SetBytesProcessed(qint64(state.iterations()) * bytesPerIteration);
+    if (framesPerIteration > 0) {
+        state.counters["frames_per_second"] = benchmark::Counter(
+            double(state.iterations()) * framesPerIteration, benchmark::Counter::kIsRate);
+    }
+}
+
+// Whole-buffer CRC, checked against the bit-at-a-time reference first
+void BM_CRC16(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 0);
+    const QByteArray prefix = data.left(qMin<qint64>(data.size(), 64 * KB));
+    if (CRC::calculateCRC16(prefix) != CRC::formatCRC16(CRC::calculateCRC16Reference(prefix))) {
+        state.SkipWithError("CRC engine disagrees with the reference");
+        return;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CRC::calculateCRC16(data));
+    }
+    setThroughput(state, data.size());
+}
+BENCHMARK(BM_CRC16)->RangeMultiplier(32)->Range(KB, GB)->Unit(benchmark::kMicrosecond);
+
+void BM_CRC16Reference(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CRC::calculateCRC16Reference(data));
+    }
+    setThroughput(state, data.size());
+}
+BENCHMARK(BM_CRC16Reference)->RangeMultiplier(32)->Range(KB, MB)->Unit(benchmark::kMicrosecond);
+
+// One CRC per 13-byte frame slot, as FrameStore::load computes them
+void BM_CRC16Batch(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 0);
+    const qint64 count = data.size() / FrameSource::FRAME_BYTE_SIZE;
+    QVector<quint16> crcs(count);
+    const uchar *payloads = reinterpret_cast<const uchar *>(data.constData());
+
+    for (auto _ : state) {
+        CRC::calculateBatch(payloads, FrameSource::FRAME_BYTE_SIZE, FrameSource::FRAME_BYTE_SIZE,
+                            count, crcs.data());
+        benchmark::DoNotOptimize(crcs.data());
+    }
+    setThroughput(state, count * FrameSource::FRAME_BYTE_SIZE, count);
+}
+BENCHMARK(BM_CRC16Batch)->RangeMultiplier(32)->Range(KB, GB)->Unit(benchmark::kMicrosecond);
+
+// Cutting 100-bit frames out of the file, checked against the reference first
+void BM_BitPacker(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 0);
+    const uchar *source = reinterpret_cast<const uchar *>(data.constData());
+    const qint64 count = FrameSource::frameCountFor(data.size());
+    uchar fast[FrameSource::FRAME_BYTE_SIZE];
+    uchar reference[FrameSource::FRAME_BYTE_SIZE];
+    for (qint64 i = 0; i < qMin<qint64>(count, 4096); ++i) {
+        BitPacker::extractBits(source, data.size(), i * FrameSource::FRAME_BIT_SIZE,
+                               FrameSource::FRAME_BIT_SIZE, fast);
+        BitPacker::extractBitsReference(source, data.size(), i * FrameSource::FRAME_BIT_SIZE,
+                                        FrameSource::FRAME_BIT_SIZE, reference);
+        if (memcmp(fast, reference, sizeof(fast)) != 0) {
+            state.SkipWithError("BitPacker disagrees with the reference");
+            return;
+        }
+    }
+
+    for (auto _ : state) {
+        for (qint64 i = 0; i < count; ++i) {
+            BitPacker::extractBits(source, data.size(), i * FrameSource::FRAME_BIT_SIZE,
+                                   FrameSource::FRAME_BIT_SIZE, fast);
+            benchmark::DoNotOptimize(fast);
+        }
+    }
+    setThroughput(state, data.size(), count);
+}
+BENCHMARK(BM_BitPacker)->RangeMultiplier(32)->Range(KB, GB)->Unit(benchmark::kMicrosecond);
+
+// The same cut done bit at a time, as before BitPacker; the 1 MB and larger
+// rows line up with BM_BitPacker to show the speedup
+void BM_BitPackerReference(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 0);
+    const uchar *source = reinterpret_cast<const uchar *>(data.constData());
+    const qint64 count = FrameSource::frameCountFor(data.size());
+    uchar reference[FrameSource::FRAME_BYTE_SIZE];
+
+    for (auto _ : state) {
+        for (qint64 i = 0; i < count; ++i) {
+            BitPacker::extractBitsReference(source, data.size(), i * FrameSource::FRAME_BIT_SIZE,
+                                            FrameSource::FRAME_BIT_SIZE, reference);
+            benchmark::DoNotOptimize(reference);
+        }
+    }
+    setThroughput(state, data.size(), count);
+}
+BENCHMARK(BM_BitPackerReference)->RangeMultiplier(32)->Range(MB, GB)->Unit(benchmark::kMillisecond);
+
+// Framing of an in-memory file: bit extraction plus batch CRC
+void BM_FrameStoreLoad(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 0);
+    FrameStore store;
+    for (auto _ : state) {
+        store.load(data);
+        benchmark::DoNotOptimize(store.count());
+    }
+    setThroughput(state, data.size(), store.count());
+}
+BENCHMARK(BM_FrameStoreLoad)->RangeMultiplier(32)->Range(KB, GB)->Unit(benchmark::kMicrosecond);
+
+// Parallel load scaling: the global pool limited to range(1) threads
+void BM_FrameStoreLoadThreads(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 0);
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int defaultThreads = pool->maxThreadCount();
+    pool->setMaxThreadCount(int(state.range(1)));
+
+    FrameStore store;
+    for (auto _ : state) {
+        store.load(data);
+        benchmark::DoNotOptimize(store.count());
+    }
+    pool->setMaxThreadCount(defaultThreads);
+    setThroughput(state, data.size(), store.count());
+}
+BENCHMARK(BM_FrameStoreLoadThreads)
+    ->ArgsProduct({{32 * MB, GB}, {1, 2, 4, 8, 16, 32}})
+    ->ArgNames({"bytes", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Cutting and CRC of every frame through the registry, per frame size
+void BM_FrameCodecCut(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 0);
+    const FrameGeometry *geometry = FrameCodecRegistry::find(int(state.range(1)));
+    const qint64 count = (qint64(data.size()) * 8 + geometry->bits - 1) / geometry->bits;
+    QByteArray payloads(count * geometry->bytes, 0);
+    QVector<quint16> crcs(count);
+    const uchar *source = reinterpret_cast<const uchar *>(data.constData());
+
+    for (auto _ : state) {
+        geometry->cut(source, data.size(), 0, count, reinterpret_cast<uchar *>(payloads.data()), crcs.data());
+        benchmark::DoNotOptimize(crcs.data());
+    }
+    setThroughput(state, data.size(), count);
+}
+BENCHMARK(BM_FrameCodecCut)
+    ->ArgsProduct({{MB, 32 * MB, GB}, {64, 100, 128, 512, 1500 * 8}})
+    ->ArgNames({"bytes", "frame_bits"})
+    ->Unit(benchmark::kMicrosecond);
+
+// Byte stuffing over sizes x flag densities (percent); 100 is the worst
+// case, where every byte is escaped and the output doubles
+void BM_ByteStuffing(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), int(state.range(1)));
+    if (ByteStuffing::stuff(data.left(64 * KB)) != ByteStuffing::stuffReference(data.left(64 * KB))) {
+        state.SkipWithError("stuffing disagrees with the reference");
+        return;
+    }
+
+    qint64 wireBytes = 0;
+    for (auto _ : state) {
+        const QByteArray stuffed = DataLinkWorker::applyByteStuffing(data);
+        wireBytes = stuffed.size();
+        benchmark::DoNotOptimize(stuffed.constData());
+    }
+    setThroughput(state, data.size());
+    state.counters["expansion"] = double(wireBytes) / data.size();
+}
+BENCHMARK(BM_ByteStuffing)
+    ->ArgsProduct({{KB, 32 * KB, MB, 32 * MB, GB}, {0, 1, 10, 50, 100}})
+    ->ArgNames({"bytes", "flag_pct"})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ByteStuffingReference(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), int(state.range(1)));
+    for (auto _ : state) {
+        const QByteArray stuffed = ByteStuffing::stuffReference(data);
+        benchmark::DoNotOptimize(stuffed.constData());
+    }
+    setThroughput(state, data.size());
+}
+BENCHMARK(BM_ByteStuffingReference)
+    ->ArgsProduct({{KB, MB}, {0, 10, 100}})
+    ->ArgNames({"bytes", "flag_pct"})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ByteDestuffing(benchmark::State &state)
+{
+    const QByteArray stuffed = DataLinkWorker::applyByteStuffing(testData(state.range(0), int(state.range(1))));
+    if (ByteStuffing::destuff(stuffed) != testData(state.range(0), int(state.range(1)))) {
+        state.SkipWithError("destuffing does not restore the input");
+        return;
+    }
+
+    for (auto _ : state) {
+        const QByteArray data = DataLinkWorker::removeByteStuffing(stuffed);
+        benchmark::DoNotOptimize(data.constData());
+    }
+    setThroughput(state, stuffed.size());
+}
+BENCHMARK(BM_ByteDestuffing)
+    ->ArgsProduct({{KB, 32 * KB, MB, 32 * MB, GB}, {0, 1, 10, 50, 100}})
+    ->ArgNames({"bytes", "flag_pct"})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_ByteDestuffingReference(benchmark::State &state)
+{
+    const QByteArray stuffed = ByteStuffing::stuffReference(testData(state.range(0), int(state.range(1))));
+    for (auto _ : state) {
+        const QByteArray data = ByteStuffing::destuffReference(stuffed);
+        benchmark::DoNotOptimize(data.constData());
+    }
+    setThroughput(state, stuffed.size());
+}
+BENCHMARK(BM_ByteDestuffingReference)
+    ->ArgsProduct({{KB, MB}, {0, 10, 100}})
+    ->ArgNames({"bytes", "flag_pct"})
+    ->Unit(benchmark::kMicrosecond);
+
+// Round trip of plain text, where no byte needs escaping
+void BM_ByteStuffingText(benchmark::State &state)
+{
+    const QByteArray text = textData(state.range(0));
+    for (auto _ : state) {
+        const QByteArray stuffed = ByteStuffing::stuff(text);
+        const QByteArray data = ByteStuffing::destuff(stuffed);
+        benchmark::DoNotOptimize(data.constData());
+    }
+    setThroughput(state, 2 * text.size());
+}
+BENCHMARK(BM_ByteStuffingText)->RangeMultiplier(32)->Range(KB, GB)->Unit(benchmark::kMicrosecond);
+
+// HDLC bit stuffing of a whole buffer; flag bytes (0x7E) carry six 1s, so
+// the density sweep also drives the number of inserted bits
+void BM_BitStuffing(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), int(state.range(1)));
+    const qint64 bits = qint64(data.size()) * 8;
+    if (BitStuffing::stuff(data.left(64 * KB), qMin<qint64>(bits, 64 * KB * 8))
+        != BitStuffing::stuffReference(data.left(64 * KB), qMin<qint64>(bits, 64 * KB * 8))) {
+        state.SkipWithError("bit stuffing disagrees with the reference");
+        return;
+    }
+
+    qint64 wireBytes = 0;
+    for (auto _ : state) {
+        const QByteArray wire = BitStuffing::stuff(data, bits);
+        wireBytes = wire.size();
+        benchmark::DoNotOptimize(wire.constData());
+    }
+    setThroughput(state, data.size());
+    state.counters["expansion"] = double(wireBytes) / data.size();
+}
+BENCHMARK(BM_BitStuffing)
+    ->ArgsProduct({{KB, MB, 32 * MB, GB}, {0, 10, 100}})
+    ->ArgNames({"bytes", "flag_pct"})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_BitDestuffing(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), int(state.range(1)));
+    const QByteArray wire = BitStuffing::stuff(data, qint64(data.size()) * 8);
+    if (BitStuffing::destuff(wire) != data) {
+        state.SkipWithError("bit destuffing does not restore the input");
+        return;
+    }
+
+    for (auto _ : state) {
+        const QByteArray payload = BitStuffing::destuff(wire);
+        benchmark::DoNotOptimize(payload.constData());
+    }
+    setThroughput(state, wire.size());
+}
+BENCHMARK(BM_BitDestuffing)
+    ->ArgsProduct({{KB, MB, 32 * MB, GB}, {0, 10, 100}})
+    ->ArgNames({"bytes", "flag_pct"})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_BitStuffingReference(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), int(state.range(1)));
+    const qint64 bits = qint64(data.size()) * 8;
+    for (auto _ : state) {
+        const QByteArray payload = BitStuffing::destuffReference(BitStuffing::stuffReference(data, bits));
+        benchmark::DoNotOptimize(payload.constData());
+    }
+    setThroughput(state, 2 * data.size());
+}
+BENCHMARK(BM_BitStuffingReference)
+    ->ArgsProduct({{KB, MB}, {0, 100}})
+    ->ArgNames({"bytes", "flag_pct"})
+    ->Unit(benchmark::kMicrosecond);
+
+// Per-frame encode and decode of 100-bit frames under each framing
+void BM_FrameCodec(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 1);
+    const FramingMode framing = state.range(1) ? FramingMode::BitStuffing : FramingMode::ByteStuffing;
+    FrameStore store;
+    store.load(data);
+
+    qint64 wireBytes = 0;
+    for (auto _ : state) {
+        wireBytes = 0;
+        for (int i = 0; i < store.count(); ++i) {
+            const QByteArray wire = DataLinkWorker::encodeFrame(framing, store.frame(i));
+            wireBytes += wire.size();
+            benchmark::DoNotOptimize(DataLinkWorker::decodeFrame(framing, wire).constData());
+        }
+    }
+    setThroughput(state, data.size(), store.count());
+    state.counters["wire_bytes_per_frame"] = store.count() ? double(wireBytes) / store.count() : 0.0;
+}
+BENCHMARK(BM_FrameCodec)
+    ->ArgsProduct({{KB, MB, 32 * MB}, {0, 1}})
+    ->ArgNames({"bytes", "bit_framing"})
+    ->Unit(benchmark::kMicrosecond);
+
+// Burst channel over a wire buffer in 121-byte frame-sized calls, at a mean
+// bit error rate of about 1e-7 (range(1) = 0) or 1e-2 (range(1) = 1). The
+// cost follows the number of errors, so the low rate runs near memory speed.
+void BM_BurstChannel(benchmark::State &state)
+{
+    QByteArray wire = testData(state.range(0), 0);
+    uchar *data = reinterpret_cast<uchar *>(wire.data());
+    BurstChannel::Parameters parameters;
+    if (state.range(1) == 0) {
+        parameters.goodToBad = 1e-9;
+        parameters.goodBitErrorRate = 1e-7;
+    }
+    const qint64 frameBytes = 121;
+    ChannelRng rng(1);
+    BurstChannel channel(parameters);
+    channel.reset(rng);
+
+    qint64 flipped = 0;
+    for (auto _ : state) {
+        for (qint64 pos = 0; pos < wire.size(); pos += frameBytes) {
+            flipped += channel.transmit(data + pos, qMin(frameBytes, wire.size() - pos) * 8, rng);
+        }
+        benchmark::DoNotOptimize(data);
+    }
+    setThroughput(state, wire.size(), (wire.size() + frameBytes - 1) / frameBytes);
+    state.counters["bit_error_rate"] = double(flipped) / (double(state.iterations()) * wire.size() * 8);
+}
+BENCHMARK(BM_BurstChannel)
+    ->ArgsProduct({{KB, MB, 32 * MB, GB}, {0, 1}})
+    ->ArgNames({"bytes", "high_ber"})
+    ->Unit(benchmark::kMicrosecond);
+
+// One million loss decisions at p = 0.1: range(0) = 0 compares a seeded
+// QRandomGenerator double, 1 a ChannelRng double and 2 takes them from
+// 64-outcome Bernoulli masks
+void BM_ChannelRng(benchmark::State &state)
+{
+    const int outcomes = 1000000;
+    const double probability = 0.1;
+    QRandomGenerator qtRng(1);
+    ChannelRng rng(1);
+    BernoulliStream stream(probability);
+
+    qint64 hits = 0;
+    for (auto _ : state) {
+        hits = 0;
+        switch (state.range(0)) {
+        case 0:
+            for (int i = 0; i < outcomes; ++i) {
+                hits += qtRng.generateDouble() < probability;
+            }
+            break;
+        case 1:
+            for (int i = 0; i < outcomes; ++i) {
+                hits += rng.nextDouble() < probability;
+            }
+            break;
+        default:
+            for (int i = 0; i < outcomes; ++i) {
+                hits += stream.next(rng);
+            }
+            break;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.counters["outcomes_per_second"] = benchmark::Counter(
+        double(state.iterations()) * outcomes, benchmark::Counter::kIsRate);
+    state.counters["hit_rate"] = double(hits) / outcomes;
+}
+BENCHMARK(BM_ChannelRng)->DenseRange(0, 2)->ArgName("source")->Unit(benchmark::kMicrosecond);
+
+// Receive side: a stream of stuffed 13-byte frames fed in chunks of
+// range(1) bytes, cut anywhere with respect to frame boundaries
+void BM_Deframer(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 1);
+    const qint64 count = data.size() / FrameSource::FRAME_BYTE_SIZE;
+    QByteArray wire;
+    wire.reserve(data.size() * 5 / 4);
+    for (qint64 i = 0; i < count; ++i) {
+        wire.append(ByteStuffing::stuff(data.mid(i * FrameSource::FRAME_BYTE_SIZE, FrameSource::FRAME_BYTE_SIZE)));
+    }
+    const qint64 chunkSize = state.range(1);
+
+    qint64 frames = 0;
+    for (auto _ : state) {
+        qint64 payloadBytes = 0;
+        Deframer deframer([&payloadBytes](const QByteArray &frame) { payloadBytes += frame.size(); });
+        for (qint64 pos = 0; pos < wire.size(); pos += chunkSize) {
+            deframer.feed(wire.constData() + pos, qMin(chunkSize, wire.size() - pos));
+        }
+        benchmark::DoNotOptimize(payloadBytes);
+        frames = deframer.framesDecoded();
+    }
+    if (frames != count) {
+        state.SkipWithError("deframer lost frames");
+        return;
+    }
+    setThroughput(state, wire.size(), frames);
+}
+BENCHMARK(BM_Deframer)
+    ->ArgsProduct({{KB, 32 * KB, MB, 32 * MB, GB}, {64, 4 * KB, MB}})
+    ->ArgNames({"bytes", "chunk"})
+    ->Unit(benchmark::kMicrosecond);
+
+// File on disk -> frames -> stuffed wire bytes; range(1) selects mapped input
+void BM_EndToEnd(benchmark::State &state)
+{
+    const QByteArray &data = testData(state.range(0), 1);
+    const bool mapped = state.range(1) != 0;
+    const QString path = QDir::temp().filePath(QString("datalink_bench_%1.bin").arg(data.size()));
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+            state.SkipWithError("cannot write the input file");
+            return;
+        }
+    }
+
+    qint64 frames = 0;
+    bool failed = false;
+    for (auto _ : state) {
+        // A failed open would otherwise time an empty store
+        FrameStore store;
+        if (mapped) {
+            QSharedPointer<FrameSource> source(new FrameSource);
+            if (!source->open(path)) {
+                state.SkipWithError("cannot map the input file");
+                failed = true;
+                break;
+            }
+            store.attach(source);
+        } else {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly)) {
+                state.SkipWithError("cannot read the input file");
+                failed = true;
+                break;
+            }
+            store.load(file.readAll());
+        }
+
+        qint64 wireBytes = 0;
+        for (int i = 0; i < store.count(); ++i) {
+            const Frame frame = store.frame(i);
+            wireBytes += DataLinkWorker::applyByteStuffing(
+                QByteArray::fromRawData(frame.getConstData(), frame.getDataSize())).size();
+        }
+        benchmark::DoNotOptimize(wireBytes);
+        frames = store.count();
+    }
+    QFile::remove(path);
+    if (!failed) {
+        setThroughput(state, data.size(), frames);
+    }
+}
+BENCHMARK(BM_EndToEnd)
+    ->ArgsProduct({{KB, 32 * KB, MB, 32 * MB, GB}, {0, 1}})
+    ->ArgNames({"bytes", "mapped"})
+    ->Unit(benchmark::kMillisecond);
+
+}
+
+BENCHMARK_MAIN();
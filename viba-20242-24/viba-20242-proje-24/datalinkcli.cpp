@@ -0,0 +1,399 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QTextStream>
+#include "datalinklayer.h"
+#include "deframer.h"
+#include "framecodec.h"
+#include "framesource.h"
+#include "framestore.h"
+#include "montecarlorunner.h"
+
+// Headless front end: frames, encodes and simulates a file on the virtual
+// clock and prints the statistics as JSON on stdout. Nothing here needs an
+// event loop, so a run costs only the work itself. With --deframe the input
+// is instead a captured wire stream, decoded in one pass.
+
+namespace {
+
+bool parseMode(const QString &name, ArqMode &mode)
+{
+    if (name == "saw" || name == "stop-and-wait") {
+        mode = ArqMode::StopAndWait;
+    } else if (name == "gbn" || name == "go-back-n") {
+        mode = ArqMode::GoBackN;
+    } else if (name == "sr" || name == "selective-repeat") {
+        mode = ArqMode::SelectiveRepeat;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseFraming(const QString &name, FramingMode &framing)
+{
+    if (name == "byte") {
+        framing = FramingMode::ByteStuffing;
+    } else if (name == "bit" || name == "hdlc") {
+        framing = FramingMode::BitStuffing;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Four comma-separated numbers: good-to-bad and bad-to-good transition
+// probabilities per bit, then the bit error rates of the two states
+bool parseChannel(const QString &text, BurstChannel::Parameters &parameters)
+{
+    const QStringList fields = text.split(",");
+    if (fields.size() != 4) {
+        return false;
+    }
+    double values[4];
+    for (int i = 0; i < 4; ++i) {
+        bool ok = false;
+        values[i] = fields.at(i).trimmed().toDouble(&ok);
+        if (!ok || values[i] < 0.0 || values[i] > 1.0) {
+            return false;
+        }
+    }
+    parameters.goodToBad = values[0];
+    parameters.badToGood = values[1];
+    parameters.goodBitErrorRate = values[2];
+    parameters.badBitErrorRate = values[3];
+    return true;
+}
+
+QJsonObject channelToJson(const BurstChannel::Parameters &parameters)
+{
+    const BurstChannel channel(parameters);
+    QJsonObject object;
+    object["goodToBad"] = parameters.goodToBad;
+    object["badToGood"] = parameters.badToGood;
+    object["goodBitErrorRate"] = parameters.goodBitErrorRate;
+    object["badBitErrorRate"] = parameters.badBitErrorRate;
+    object["badStateShare"] = channel.badStateShare();
+    object["meanBitErrorRate"] = channel.meanBitErrorRate();
+    return object;
+}
+
+QString modeKey(ArqMode mode)
+{
+    switch (mode) {
+    case ArqMode::GoBackN:
+        return "go-back-n";
+    case ArqMode::SelectiveRepeat:
+        return "selective-repeat";
+    default:
+        return "stop-and-wait";
+    }
+}
+
+QJsonObject estimateToJson(const MonteCarloRunner::Estimate &estimate)
+{
+    QJsonObject object;
+    object["mean"] = estimate.mean;
+    object["variance"] = estimate.variance;
+    object["ciLow"] = estimate.ciLow;
+    object["ciHigh"] = estimate.ciHigh;
+    return object;
+}
+
+QJsonObject trialToJson(const DataLinkWorker::TrialResult &trial)
+{
+    QJsonObject object;
+    object["seed"] = QString::number(trial.seed);
+    object["deliveredFrames"] = trial.deliveredFrames;
+    object["failedFrames"] = trial.failedFrames;
+    object["transmissions"] = trial.transmissions;
+    object["retransmissions"] = trial.retransmissions;
+    object["lostFrames"] = trial.lostFrames;
+    object["corruptedFrames"] = trial.corruptedFrames;
+    object["ackLosses"] = trial.ackLosses;
+    object["misdeliveredFrames"] = trial.misdeliveredFrames;
+    object["skipNotices"] = trial.skipNotices;
+    object["wireBytes"] = trial.wireBytes;
+    object["bitErrors"] = trial.bitErrors;
+    object["simulatedSeconds"] = trial.simulatedMs / 1000.0;
+    object["goodputBitsPerSecond"] = trial.goodput;
+    return object;
+}
+
+QJsonObject summaryToJson(const MonteCarloRunner::Summary &summary)
+{
+    QJsonObject object;
+    object["trials"] = summary.trials;
+    object["seed"] = QString::number(summary.seed);
+    object["goodputBitsPerSecond"] = estimateToJson(summary.goodput);
+    object["retransmissions"] = estimateToJson(summary.retransmissions);
+    object["lostFrames"] = estimateToJson(summary.lostFrames);
+    object["corruptedFrames"] = estimateToJson(summary.corruptedFrames);
+    object["ackLosses"] = estimateToJson(summary.ackLosses);
+    object["failedFrames"] = estimateToJson(summary.failedFrames);
+    object["simulatedSeconds"] = estimateToJson(summary.simulatedSeconds);
+    return object;
+}
+
+// Size of the reads used to stream a capture through the deframer
+const qint64 DEFRAME_CHUNK_SIZE = 1024 * 1024;
+
+int fail(const QString &message)
+{
+    QTextStream(stderr) << "datalink-cli: " << message << "\n";
+    return 1;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("datalink-cli");
+    QCoreApplication::setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Frames, encodes and simulates a file over the data link layer.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("file", "Input file to transmit.");
+
+    QCommandLineOption modeOption(QStringList() << "m" << "mode",
+        "ARQ scheme: saw, gbn or sr (default saw).", "mode", "saw");
+    QCommandLineOption windowOption(QStringList() << "w" << "window",
+        "Sliding window size for gbn and sr.", "frames", QString::number(DataLinkWorker::DEFAULT_WINDOW_SIZE));
+    QCommandLineOption framingOption(QStringList() << "f" << "framing",
+        "Wire framing: byte (stuffing) or bit (HDLC bit stuffing), default byte.", "framing", "byte");
+    QCommandLineOption channelOption(QStringList() << "c" << "channel",
+        "Burst channel as p(good->bad),p(bad->good),BER good,BER bad per wire bit.",
+        "params", QString("%1,%2,%3,%4")
+            .arg(BurstChannel::DEFAULT_GOOD_TO_BAD)
+            .arg(BurstChannel::DEFAULT_BAD_TO_GOOD)
+            .arg(BurstChannel::DEFAULT_GOOD_BIT_ERROR_RATE)
+            .arg(BurstChannel::DEFAULT_BAD_BIT_ERROR_RATE));
+    QStringList frameSizes;
+    for (int bits : FrameCodecRegistry::frameSizes()) {
+        frameSizes.append(QString::number(bits));
+    }
+    QCommandLineOption frameBitsOption(QStringList() << "b" << "frame-bits",
+        QString("Frame size in bits: %1 (default %2).").arg(frameSizes.join(", ")).arg(FrameSource::FRAME_BIT_SIZE),
+        "bits", QString::number(FrameSource::FRAME_BIT_SIZE));
+    QCommandLineOption seedOption(QStringList() << "s" << "seed",
+        "Channel seed; equal seeds give equal results.", "seed", "1");
+    QCommandLineOption trialsOption(QStringList() << "t" << "trials",
+        "Number of Monte Carlo trials (default 1).", "count", "1");
+    QCommandLineOption mappedOption("mapped", "Memory-map the input instead of reading it.");
+    QCommandLineOption compactOption("compact", "Print the JSON on one line.");
+    QCommandLineOption wireOption("wire",
+        "Also write the encoded wire stream to this file.", "path");
+    QCommandLineOption deframeOption("deframe",
+        "Treat the input as a wire stream and deframe it instead.");
+    parser.addOption(modeOption);
+    parser.addOption(windowOption);
+    parser.addOption(framingOption);
+    parser.addOption(channelOption);
+    parser.addOption(frameBitsOption);
+    parser.addOption(seedOption);
+    parser.addOption(trialsOption);
+    parser.addOption(mappedOption);
+    parser.addOption(compactOption);
+    parser.addOption(wireOption);
+    parser.addOption(deframeOption);
+    parser.process(app);
+
+    const QStringList positional = parser.positionalArguments();
+    if (positional.size() != 1) {
+        return fail("expected exactly one input file");
+    }
+    const QString filePath = positional.first();
+
+    ArqMode mode = ArqMode::StopAndWait;
+    if (!parseMode(parser.value(modeOption), mode)) {
+        return fail(QString("unknown mode '%1'").arg(parser.value(modeOption)));
+    }
+    FramingMode framing = FramingMode::ByteStuffing;
+    if (!parseFraming(parser.value(framingOption), framing)) {
+        return fail(QString("unknown framing '%1'").arg(parser.value(framingOption)));
+    }
+    BurstChannel::Parameters channel;
+    if (!parseChannel(parser.value(channelOption), channel)) {
+        return fail("channel must be four probabilities between 0 and 1, separated by commas");
+    }
+    bool ok = false;
+    const int frameBits = parser.value(frameBitsOption).toInt(&ok);
+    if (!ok || !FrameCodecRegistry::find(frameBits)) {
+        return fail(QString("frame size must be one of %1 bits").arg(frameSizes.join(", ")));
+    }
+    if (parser.isSet(mappedOption) && frameBits != FrameSource::FRAME_BIT_SIZE) {
+        return fail(QString("--mapped reads %1-bit frames only").arg(FrameSource::FRAME_BIT_SIZE));
+    }
+    const int window = parser.value(windowOption).toInt(&ok);
+    if (!ok || window < 1 || window > DataLinkWorker::MAX_WINDOW_SIZE) {
+        return fail(QString("window must be between 1 and %1").arg(DataLinkWorker::MAX_WINDOW_SIZE));
+    }
+    const quint64 seed = parser.value(seedOption).toULongLong(&ok);
+    if (!ok) {
+        return fail("seed must be an unsigned integer");
+    }
+    const int trials = parser.value(trialsOption).toInt(&ok);
+    if (!ok || trials < 1) {
+        return fail("trials must be a positive integer");
+    }
+
+    const QJsonDocument::JsonFormat format = parser.isSet(compactOption) ? QJsonDocument::Compact
+                                                                         : QJsonDocument::Indented;
+
+    if (parser.isSet(deframeOption)) {
+        if (framing != FramingMode::ByteStuffing) {
+            return fail("--deframe reads byte-stuffed streams only");
+        }
+        QFile capture(filePath);
+        if (!capture.open(QIODevice::ReadOnly)) {
+            return fail(QString("cannot open %1").arg(filePath));
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        qint64 payloadBytes = 0;
+        quint8 checksum = 0;
+        Deframer deframer([&](const QByteArray &frame) {
+            payloadBytes += frame.size();
+            for (const char byte : frame) {
+                checksum += static_cast<quint8>(byte);
+            }
+        });
+        QByteArray chunk(DEFRAME_CHUNK_SIZE, Qt::Uninitialized);
+        qint64 read = 0;
+        while ((read = capture.read(chunk.data(), chunk.size())) > 0) {
+            deframer.feed(chunk.constData(), read);
+        }
+        const qint64 deframingNs = timer.nsecsElapsed();
+        if (read < 0) {
+            return fail(QString("cannot read %1").arg(filePath));
+        }
+
+        QJsonObject input;
+        input["file"] = QFileInfo(filePath).fileName();
+        input["bytes"] = deframer.bytesConsumed();
+
+        QJsonObject deframing;
+        deframing["frames"] = deframer.framesDecoded();
+        deframing["payloadBytes"] = payloadBytes;
+        deframing["discardedBytes"] = deframer.bytesDiscarded();
+        deframing["oversizedFrames"] = deframer.oversizedFrames();
+        deframing["abortedFrames"] = deframer.abortedFrames();
+        deframing["checksum"] = checksum;
+
+        QJsonObject timing;
+        timing["deframingMs"] = deframingNs / 1e6;
+
+        QJsonObject report;
+        report["input"] = input;
+        report["deframing"] = deframing;
+        report["timing"] = timing;
+        QTextStream(stdout) << QJsonDocument(report).toJson(format);
+        return 0;
+    }
+
+    QFile wireFile;
+    if (parser.isSet(wireOption)) {
+        wireFile.setFileName(parser.value(wireOption));
+        if (!wireFile.open(QIODevice::WriteOnly)) {
+            return fail(QString("cannot create %1").arg(parser.value(wireOption)));
+        }
+    }
+
+    // Framing
+    QElapsedTimer timer;
+    timer.start();
+    FrameStore store;
+    qint64 fileSize = 0;
+    if (parser.isSet(mappedOption)) {
+        QSharedPointer<FrameSource> source(new FrameSource);
+        if (!source->open(filePath)) {
+            return fail(QString("cannot map %1").arg(filePath));
+        }
+        fileSize = source->fileSize();
+        store.attach(source);
+    } else {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return fail(QString("cannot open %1").arg(filePath));
+        }
+        // Frames are cut in parallel straight from a temporary mapping
+        fileSize = file.size();
+        uchar *mapped = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+        if (mapped) {
+            store.load(mapped, fileSize, frameBits);
+            file.unmap(mapped);
+        } else {
+            const QByteArray fileData = file.readAll();
+            fileSize = fileData.size();
+            store.load(fileData, frameBits);
+        }
+    }
+    const qint64 framingNs = timer.nsecsElapsed();
+
+    // Encoding: every frame is put between flags as on the wire
+    timer.restart();
+    qint64 encodedBytes = 0;
+    for (int i = 0; i < store.count(); ++i) {
+        const QByteArray wire = DataLinkWorker::encodeFrame(framing, store.frame(i));
+        encodedBytes += wire.size();
+        if (wireFile.isOpen() && wireFile.write(wire) != wire.size()) {
+            return fail(QString("cannot write %1").arg(wireFile.fileName()));
+        }
+    }
+    const qint64 encodingNs = timer.nsecsElapsed();
+
+    // Simulation on the virtual clock
+    timer.restart();
+    MonteCarloRunner runner;
+    runner.setData(store);
+    runner.setArqMode(mode, window);
+    runner.setFramingMode(framing);
+    runner.setChannelParameters(channel);
+    const QVector<DataLinkWorker::TrialResult> results = runner.runTrials(trials, seed);
+    const qint64 simulationNs = timer.nsecsElapsed();
+
+    QJsonObject input;
+    input["file"] = QFileInfo(filePath).fileName();
+    input["bytes"] = fileSize;
+    input["frames"] = store.count();
+    input["frameBits"] = store.frameBitSize();
+    input["partialFrame"] = store.hasPartialFrame();
+    input["mapped"] = store.isMapped();
+
+    QJsonObject encoding;
+    encoding["framing"] = (framing == FramingMode::BitStuffing) ? "bit" : "byte";
+    encoding["wireBytes"] = encodedBytes;
+    encoding["overheadBytes"] = encodedBytes - qint64(store.count()) * store.frameByteSize();
+
+    QJsonObject timing;
+    timing["framingMs"] = framingNs / 1e6;
+    timing["encodingMs"] = encodingNs / 1e6;
+    timing["simulationMs"] = simulationNs / 1e6;
+
+    QJsonObject report;
+    report["input"] = input;
+    report["encoding"] = encoding;
+    report["mode"] = modeKey(mode);
+    report["window"] = (mode == ArqMode::StopAndWait) ? 1 : window;
+    report["channel"] = channelToJson(channel);
+    report["seed"] = QString::number(seed);
+    report["timing"] = timing;
+    if (trials == 1) {
+        report["simulation"] = trialToJson(results.first());
+    } else {
+        report["monteCarlo"] = summaryToJson(runner.summarize(results, seed));
+    }
+
+    const QJsonDocument document(report);
+    QTextStream(stdout) << document.toJson(format);
+    return 0;
+}
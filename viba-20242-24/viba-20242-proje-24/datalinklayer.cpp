@@ -3,60 +3,55 @@
 #include <QDataStream>
 #include <QRandomGenerator>
 #include <QThread>
-#include <QBitArray>
 #include "crc.h"
+#include "framesource.h"
+#include "montecarlorunner.h"
 #include <QDebug>
 
 // DataLinkWorker Implementation
-DataLinkWorker::DataLinkWorker(QObject *parent) : QObject(parent)
+DataLinkWorker::DataLinkWorker(QObject *parent)
+    : QObject(parent)
+    , arqMode(ArqMode::StopAndWait)
+    , framingMode(FramingMode::ByteStuffing)
+    , windowSize(DEFAULT_WINDOW_SIZE)
+    , realTime(false)
+    , eventChannel(nullptr)
 {
 }
 
-void DataLinkWorker::setData(const QVector<Frame>& newFrames)
+void DataLinkWorker::setData(const FrameStore &newStore)
 {
     mutex.lock();
-    frames = newFrames;
+    store = newStore;
     mutex.unlock();
 }
 
-QByteArray DataLinkWorker::applyByteStuffing(const QByteArray &data) const
+QByteArray DataLinkWorker::applyByteStuffing(const QByteArray &data)
 {
-    QByteArray stuffed;
-    stuffed.append(FRAME_FLAG); // Start flag
-    
-    for (const char &ch : data) {
-        if (ch == FRAME_FLAG || ch == ESCAPE_CHAR) {
-            stuffed.append(ESCAPE_CHAR);
-            stuffed.append(ch ^ 0x20); // XOR with 0x20 to transform the character
-        } else {
-            stuffed.append(ch);
-        }
+    return ByteStuffing::stuff(data);
+}
+
+QByteArray DataLinkWorker::removeByteStuffing(const QByteArray &stuffedData)
+{
+    return ByteStuffing::destuff(stuffedData);
+}
+
+QByteArray DataLinkWorker::encodeFrame(FramingMode framing, const Frame &frame)
+{
+    // Zero-copy view of the payload; the frame keeps the shared buffer alive
+    const QByteArray payload = QByteArray::fromRawData(frame.getConstData(), frame.getDataSize());
+    if (framing == FramingMode::BitStuffing) {
+        return BitStuffing::stuff(payload, frame.getBitCount());
     }
-    
-    stuffed.append(FRAME_FLAG); // End flag
-    return stuffed;
+    return ByteStuffing::stuff(payload);
 }
 
-QByteArray DataLinkWorker::removeByteStuffing(const QByteArray &stuffedData) const
+QByteArray DataLinkWorker::decodeFrame(FramingMode framing, const QByteArray &wire)
 {
-    QByteArray destuffed;
-    bool escaped = false;
-    
-    // Skip the start flag
-    for (int i = 1; i < stuffedData.size() - 1; i++) {
-        char ch = stuffedData[i];
-        
-        if (escaped) {
-            destuffed.append(ch ^ 0x20); // Reverse the XOR transformation
-            escaped = false;
-        } else if (ch == ESCAPE_CHAR) {
-            escaped = true;
-        } else {
-            destuffed.append(ch);
-        }
+    if (framing == FramingMode::BitStuffing) {
+        return BitStuffing::destuff(wire);
     }
-    
-    return destuffed;
+    return ByteStuffing::destuff(wire);
 }
 
 void DataLinkWorker::process()
@@ -64,130 +59,39 @@ void DataLinkWorker::process()
     qDebug() << "Starting transmission process...";
     
     try {
-        const int MAX_RETRIES = 3;
-        int frameCount = 0;
+        // A fresh seed per interactive run, logged so runTrial() can replay it
+        const quint64 seed = QRandomGenerator::global()->generate64();
+        RunState run;
+        prepareRun(run, seed);
 
-        mutex.lock();
-        if (frames.isEmpty()) {
-            mutex.unlock();
+        // Frames are views into the store, or cut from the mapping one at a time
+        if (run.frames.isEmpty()) {
             emit errorOccurred("No frames to process");
             return;
         }
+        emit statusUpdate(QString("Channel seed: %1").arg(seed));
 
-        QVector<Frame> localFrames = frames; // Create a local copy
-        mutex.unlock();
-
-        qDebug() << "Processing" << localFrames.size() << "frames";
-
-        for (Frame &frame : localFrames) {
-            if (QThread::currentThread()->isInterruptionRequested()) {
-                qDebug() << "Transmission interrupted by user";
-                emit statusUpdate("Transmission stopped by user");
-                return;
-            }
-
-            frameCount++;
-            qDebug() << "Processing frame" << frame.getFrameNumber();
-            
-            int retryCount = 0;
-            bool acked = false;
-
-            while (!acked && retryCount < MAX_RETRIES) {
-                try {
-                    qDebug() << "Attempting to process frame" << frame.getFrameNumber() << "(Attempt" << retryCount + 1 << "/" << MAX_RETRIES << ")";
-
-                    // Calculate CRC for the frame
-                    frame.calculateCRC();
-                    qDebug() << "Frame" << frame.getFrameNumber() << "CRC calculated";
-
-                    // Apply byte stuffing to frame data
-                    QByteArray stuffedData = applyByteStuffing(frame.getData());
-                    frame.setData(stuffedData);
-                    qDebug() << "Frame" << frame.getFrameNumber() << "byte stuffing applied";
-
-                    // Simulate transmission errors
-                    if (simulateDataLoss()) {
-                        qDebug() << "Frame" << frame.getFrameNumber() << "lost (Attempt" << retryCount + 1 << "/" << MAX_RETRIES << ")";
-                        frame.setValid(false);
-                        frame.addErrorInfo("Lost", QString("Frame lost during transmission (Attempt %1/%2)").arg(retryCount + 1).arg(MAX_RETRIES));
-                        emit statusUpdate(QString("Frame %1 lost during transmission (Attempt %2/%3)")
-                            .arg(frame.getFrameNumber())
-                            .arg(retryCount + 1)
-                            .arg(MAX_RETRIES));
-                        retryCount++;
-                        QThread::msleep(100);
-                        continue;
-                    }
-
-                    if (simulateDataCorruption()) {
-                        qDebug() << "Frame" << frame.getFrameNumber() << "corrupted (Attempt" << retryCount + 1 << "/" << MAX_RETRIES << ")";
-                        frame.setValid(false);
-                        frame.addErrorInfo("Corrupted", QString("Frame corrupted during transmission (Attempt %1/%2)").arg(retryCount + 1).arg(MAX_RETRIES));
-                        emit statusUpdate(QString("Frame %1 corrupted during transmission (Attempt %2/%3)")
-                            .arg(frame.getFrameNumber())
-                            .arg(retryCount + 1)
-                            .arg(MAX_RETRIES));
-                        retryCount++;
-                        QThread::msleep(100);
-                        continue;
-                    }
-
-                    // Send frame
-                    qDebug() << "Sending frame" << frame.getFrameNumber();
-                    emit frameProcessed(frame);
-
-                    // Remove byte stuffing after successful transmission
-                    QByteArray destuffedData = removeByteStuffing(frame.getData());
-                    frame.setData(destuffedData);
-                    qDebug() << "Frame" << frame.getFrameNumber() << "byte stuffing removed";
-
-                    // Simulate ACK loss
-                    if (simulateAckLoss()) {
-                        qDebug() << "ACK lost for frame" << frame.getFrameNumber() << "(Attempt" << retryCount + 1 << "/" << MAX_RETRIES << ")";
-                        frame.setValid(false);
-                        frame.addErrorInfo("ACK Lost", QString("ACK lost during transmission (Attempt %1/%2)").arg(retryCount + 1).arg(MAX_RETRIES));
-                        emit statusUpdate(QString("ACK lost for frame %1 (Attempt %2/%3)")
-                            .arg(frame.getFrameNumber())
-                            .arg(retryCount + 1)
-                            .arg(MAX_RETRIES));
-                        retryCount++;
-                        QThread::msleep(100);
-                        continue;
-                    }
-
-                    // Frame successfully transmitted and acknowledged
-                    acked = true;
-                    qDebug() << "Frame" << frame.getFrameNumber() << "successfully transmitted and acknowledged";
-                    emit statusUpdate(QString("Frame %1 successfully transmitted and acknowledged")
-                        .arg(frame.getFrameNumber()));
-
-                    QThread::msleep(200);
-                } catch (const std::exception& e) {
-                    qDebug() << "Error processing frame" << frame.getFrameNumber() << ":" << e.what();
-                    retryCount++;
-                    QThread::msleep(100);
-                }
-            }
+        qDebug() << "Processing" << run.frames.count() << "frames";
 
-            if (!acked) {
-                frame.setValid(false);
-                frame.addErrorInfo("Transmission Failed", 
-                    QString("Maximum retry attempts (%1) reached").arg(MAX_RETRIES));
-                qDebug() << "Frame" << frame.getFrameNumber() << "transmission failed after" << MAX_RETRIES << "attempts";
-                emit statusUpdate(QString("Frame %1 transmission failed after %2 attempts")
-                    .arg(frame.getFrameNumber())
-                    .arg(MAX_RETRIES));
-            }
+        if (!processSlidingWindow(run)) {
+            qDebug() << "Transmission interrupted by user";
+            emit framesRecorded(run.frames);
+            emit statusUpdate("Transmission stopped by user");
+            emit transmissionStopped();
+            return;
         }
 
+        emit framesRecorded(run.frames);
+        reportThroughput(run);
+
         qDebug() << "All frames processed, calculating checksum...";
-        calculateChecksum();
+        calculateChecksum(run.checksumAccumulator);
 
         QString checksumFrame = prepareChecksumFrame();
         emit checksumFrameSent(checksumFrame);
         qDebug() << "Checksum frame sent:" << checksumFrame;
 
-        if (simulateChecksumError()) {
+        if (simulateChecksumError(run)) {
             qDebug() << "Checksum error detected";
             emit errorOccurred("Checksum error detected");
         }
@@ -204,17 +108,554 @@ void DataLinkWorker::process()
     }
 }
 
-void DataLinkWorker::calculateChecksum()
+void DataLinkWorker::prepareRun(RunState &run, quint64 seed)
 {
-    quint8 accum = 0;
-    for (const auto &frame : frames) {
-        bool ok;
-        quint16 crc = frame.getCRC().toUShort(&ok, 16);
-        if (ok) {
-            accum += crc; // Addition instead of XOR
-            accum %= 0x100; // Modulo 256 (8-bit)
+    mutex.lock();
+    run.frames = store; // Create a local (shared) copy
+    run.mode = arqMode;
+    run.framing = framingMode;
+    run.realTime = realTime;
+    run.events = eventChannel;
+    run.channel = BurstChannel(channelParameters);
+    counters.reset();
+    // Stop-and-wait is a window of one; Selective Repeat needs 2W sequence numbers
+    run.window = (arqMode == ArqMode::StopAndWait) ? 1 : windowSize;
+    run.sequenceModulus = sequenceModulusFor(arqMode == ArqMode::SelectiveRepeat ? 2 * run.window - 1 : run.window);
+    mutex.unlock();
+
+    run.rng.seed(seed);
+    run.channel.reset(run.rng);
+    run.frameLoss = BernoulliStream(LOSS_PROBABILITY);
+    run.ackLoss = BernoulliStream(ACK_LOSS_PROBABILITY);
+    run.checksumError = BernoulliStream(CHECKSUM_ERROR_PROBABILITY);
+}
+
+DataLinkWorker::TrialResult DataLinkWorker::runTrial(quint64 seed)
+{
+    RunState run;
+    prepareRun(run, seed);
+    run.realTime = false;
+    run.reporting = false;
+    processSlidingWindow(run);
+
+    TrialResult result;
+    result.seed = seed;
+    result.deliveredFrames = run.deliveredFrames;
+    result.failedFrames = run.failedFrames;
+    result.transmissions = run.transmissions;
+    result.retransmissions = run.retransmissions;
+    result.lostFrames = run.lostFrames;
+    result.corruptedFrames = run.corruptedFrames;
+    result.ackLosses = run.ackLosses;
+    result.misdeliveredFrames = run.misdeliveredFrames;
+    result.skipNotices = run.skipNotices;
+    result.wireBytes = run.wireBytes;
+    result.bitErrors = run.bitErrors;
+    result.simulatedMs = run.simulatedMs;
+    result.goodput = run.simulatedMs > 0
+        ? run.deliveredFrames * double(run.frames.frameBitSize()) / (run.simulatedMs / 1000.0) : 0.0;
+    return result;
+}
+
+bool DataLinkWorker::processSlidingWindow(RunState &run)
+{
+    const int totalFrames = run.frames.count();
+
+    if (run.reporting) emit statusUpdate(QString("%1: window %2, sequence numbers modulo %3, %4 framing, %5 clock")
+        .arg(modeName(run.mode))
+        .arg(run.window)
+        .arg(run.sequenceModulus)
+        .arg(framingName(run.framing))
+        .arg(run.realTime ? "real-time" : "virtual"));
+
+    startNextTransmission(run);
+    while (run.base < totalFrames && !run.scheduler.isEmpty()) {
+        if (QThread::currentThread()->isInterruptionRequested()) {
+            return false;
         }
+
+        const qint64 before = run.scheduler.now();
+        const EventScheduler::Event event = run.scheduler.takeNext();
+        if (run.realTime && event.time > before) {
+            QThread::msleep(static_cast<unsigned long>(event.time - before));
+        }
+
+        switch (event.type) {
+        case EventScheduler::TransmitComplete:
+            run.linkBusy = false;
+            startNextTransmission(run);
+            break;
+        case EventScheduler::FrameArrival:
+            handleFrameArrival(run, event);
+            break;
+        case EventScheduler::SkipArrival:
+            handleSkipArrival(run, event);
+            break;
+        case EventScheduler::AckArrival:
+            handleAckArrival(run, event);
+            break;
+        case EventScheduler::Timeout:
+            handleTimeout(run, event);
+            break;
+        }
+    }
+
+    run.simulatedMs = run.scheduler.now();
+    return true;
+}
+
+void DataLinkWorker::startNextTransmission(RunState &run)
+{
+    if (run.linkBusy) {
+        return;
+    }
+
+    // Retransmissions go first, then new frames while the window has room
+    int index = -1;
+    while (index < 0 && !run.retransmitQueue.isEmpty()) {
+        const int candidate = run.retransmitQueue.takeFirst();
+        if (candidate >= run.base) {
+            const PendingFrame &pending = run.outstanding.at(candidate - run.base);
+            if (!pending.acked && !pending.failed) {
+                index = candidate;
+            }
+        }
+    }
+    if (index < 0 && run.outstanding.size() < run.window
+        && run.base + run.outstanding.size() < run.frames.count()) {
+        PendingFrame pending;
+        pending.frame = run.frames.frame(run.base + run.outstanding.size());
+        run.checksumAccumulator += pending.frame.getCRCValue(); // Addition modulo 256 (8-bit)
+        run.outstanding.append(pending);
+        index = run.base + run.outstanding.size() - 1;
+    }
+    if (index < 0) {
+        return;
+    }
+
+    PendingFrame &pending = run.outstanding[index - run.base];
+    Frame &frame = pending.frame;
+    countTransmission(run, pending.sent);
+    pending.sent = true;
+    pending.generation++;
+    frame.setAttempts(frame.getAttempts() + 1);
+
+    // The link is busy for one frame time; the timer covers the round trip
+    run.linkBusy = true;
+    run.scheduler.schedule(FRAME_TIME_MS, EventScheduler::TransmitComplete, index);
+    run.scheduler.schedule(FRAME_TIME_MS + 2 * PROPAGATION_DELAY_MS, EventScheduler::Timeout,
+                           index, pending.generation);
+
+    const ChannelResult result = sendOverChannel(run, frame);
+    if (result == ChannelResult::Delivered) {
+        run.scheduler.schedule(FRAME_TIME_MS + PROPAGATION_DELAY_MS, EventScheduler::FrameArrival,
+                               index, index % run.sequenceModulus);
+        return;
+    }
+
+    const bool lost = (result == ChannelResult::Lost);
+    frame.setValid(false);
+    frame.addError(lost ? Frame::Lost : Frame::Corrupted);
+    if (lost) {
+        run.lostFrames++;
+        counters.add(LinkCounters::Losses);
+    } else {
+        run.corruptedFrames++;
+        counters.add(LinkCounters::Corruptions);
+    }
+    if (run.reporting) {
+        publish(run, lost ? LinkEvent::FrameLost : LinkEvent::FrameCorrupted, frame);
+    }
+}
+
+void DataLinkWorker::handleFrameArrival(RunState &run, const EventScheduler::Event &event)
+{
+    // The receiver decides on the sequence number alone. frameIndex only
+    // says which frame is physically on the wire, so a sequence number
+    // reused too early hands the receiver the wrong frame.
+    const int sequence = event.tag;
+    const Frame frame = event.frameIndex >= run.base
+        ? run.outstanding.at(event.frameIndex - run.base).frame
+        : run.frames.frame(event.frameIndex);
+
+    if (run.mode == ArqMode::GoBackN) {
+        // Only the next sequence number in order is accepted; every arrival
+        // is answered with the cumulative ACK of the next one expected
+        if (sequence == run.expected % run.sequenceModulus) {
+            if (run.reporting) publish(run, LinkEvent::FrameDelivered, frame);
+            recordDelivery(run, frame, run.expected);
+            run.expected++;
+        }
+        sendAck(run, event.frameIndex, run.expected % run.sequenceModulus);
+        return;
+    }
+
+    // Selective Repeat and stop-and-wait: buffer anything inside the
+    // receive window and ACK it individually; duplicates are only ACKed
+    if (sequenceOffset(run, sequence, run.expected) < run.window
+        && !run.reorderBuffer.contains(sequence)) {
+        run.reorderBuffer.insert(sequence, frame);
+        if (run.reporting) publish(run, LinkEvent::FrameDelivered, frame);
+        deliverInOrder(run);
+    }
+    sendAck(run, event.frameIndex, sequence);
+}
+
+void DataLinkWorker::sendAck(RunState &run, int index, int ack)
+{
+    if (!simulateAckLoss(run)) {
+        run.scheduler.schedule(PROPAGATION_DELAY_MS, EventScheduler::AckArrival, index, ack);
+        return;
+    }
+
+    run.ackLosses++;
+    counters.add(LinkCounters::AckLosses);
+    if (index < run.base) {
+        return;
+    }
+    Frame &frame = run.outstanding[index - run.base].frame;
+    frame.setValid(false);
+    frame.addError(Frame::AckLost);
+    if (run.reporting) {
+        publish(run, LinkEvent::AckLost, frame);
+    }
+}
+
+void DataLinkWorker::sendSkipNotice(RunState &run, int index)
+{
+    // A control frame carrying the sequence number given up on. It can be
+    // lost like any frame, and so can the ACK answering it, so it goes out
+    // again every round trip until an ACK covers the frame.
+    PendingFrame &pending = run.outstanding[index - run.base];
+    pending.generation++;
+    run.skipNotices++;
+    run.scheduler.schedule(2 * PROPAGATION_DELAY_MS, EventScheduler::Timeout, index, pending.generation);
+    if (simulateDataLoss(run)) {
+        return;
+    }
+    run.scheduler.schedule(PROPAGATION_DELAY_MS, EventScheduler::SkipArrival,
+                           index, index % run.sequenceModulus);
+}
+
+void DataLinkWorker::handleSkipArrival(RunState &run, const EventScheduler::Event &event)
+{
+    const int sequence = event.tag;
+    if (run.mode == ArqMode::GoBackN) {
+        // Step over the sequence number if it is the one the receiver waits
+        // for, and answer with the cumulative ACK either way
+        if (sequence == run.expected % run.sequenceModulus) {
+            run.expected++;
+        }
+        sendAck(run, event.frameIndex, run.expected % run.sequenceModulus);
+        return;
+    }
+
+    // Selective Repeat and stop-and-wait: note the skip if it falls inside
+    // the receive window, and ACK the sequence number like a frame
+    if (sequenceOffset(run, sequence, run.expected) < run.window
+        && !run.reorderBuffer.contains(sequence)) {
+        run.skippedSequences.insert(sequence);
+        deliverInOrder(run);
+    }
+    sendAck(run, event.frameIndex, sequence);
+}
+
+void DataLinkWorker::handleAckArrival(RunState &run, const EventScheduler::Event &event)
+{
+    // ACKs carry sequence numbers; the sender maps them back onto its window
+    const int offset = sequenceOffset(run, event.tag, run.base);
+    if (run.mode == ArqMode::GoBackN) {
+        // Cumulative: everything before the ACKed sequence number has arrived
+        if (offset <= run.outstanding.size()) {
+            for (int i = 0; i < offset; ++i) {
+                run.outstanding[i].acked = true;
+            }
+        }
+    } else if (offset < run.outstanding.size()) {
+        run.outstanding[offset].acked = true;
+    }
+
+    slideWindow(run);
+    startNextTransmission(run);
+}
+
+void DataLinkWorker::handleTimeout(RunState &run, const EventScheduler::Event &event)
+{
+    const int index = event.frameIndex;
+    if (index < run.base) {
+        return;
+    }
+    PendingFrame &pending = run.outstanding[index - run.base];
+    if (pending.acked || pending.generation != event.tag) {
+        return; // Stale timer
+    }
+    if (pending.failed) {
+        // Neither the skip notice nor an ACK covering it came back
+        sendSkipNotice(run, index);
+        return;
+    }
+
+    // Go-Back-N resends frames for the base frame's timeouts too, so a frame
+    // gives up after MAX_ATTEMPTS of its own timeouts rather than sends
+    pending.timeouts++;
+    if (pending.timeouts >= Frame::MAX_ATTEMPTS) {
+        pending.failed = true;
+        reportFailure(run, pending.frame);
+        // The frame stays in the window until the receiver has taken the
+        // skip notice and an ACK covering the frame has come back
+        sendSkipNotice(run, index);
+    } else if (run.mode == ArqMode::GoBackN) {
+        // Go back: resend every unacknowledged frame from the base, and
+        // drop the timers of the ones still in flight
+        for (int i = 0; i < run.outstanding.size(); ++i) {
+            PendingFrame &resend = run.outstanding[i];
+            if (resend.acked || resend.failed) {
+                continue;
+            }
+            resend.generation++;
+            if (!run.retransmitQueue.contains(run.base + i)) {
+                run.retransmitQueue.append(run.base + i);
+            }
+        }
+    } else {
+        run.retransmitQueue.append(index);
+    }
+
+    startNextTransmission(run);
+}
+
+void DataLinkWorker::deliverInOrder(RunState &run)
+{
+    // Hands buffered frames up in order, stepping over the sequence numbers
+    // skip notices arrived for. A copy of the frame that made it after all
+    // is still delivered.
+    while (true) {
+        const int sequence = run.expected % run.sequenceModulus;
+        const bool skipped = run.skippedSequences.remove(sequence);
+        if (run.reorderBuffer.contains(sequence)) {
+            recordDelivery(run, run.reorderBuffer.take(sequence), run.expected);
+        } else if (!skipped) {
+            break;
+        }
+        run.expected++;
+    }
+}
+
+void DataLinkWorker::slideWindow(RunState &run)
+{
+    // A failed frame is stepped over once the ACK to its skip notice arrives
+    while (!run.outstanding.isEmpty() && run.outstanding.first().acked) {
+        if (run.reporting && !run.outstanding.first().failed) {
+            publish(run, LinkEvent::FrameAcked, run.outstanding.first().frame);
+        }
+        run.outstanding.removeFirst();
+        run.base++;
+    }
+}
+
+DataLinkWorker::ChannelResult DataLinkWorker::sendOverChannel(RunState &run, const Frame &frame)
+{
+    QByteArray wire = encodeFrame(run.framing, frame);
+    run.wireBytes += wire.size();
+    counters.add(LinkCounters::WireBytes, wire.size());
+
+    // Lost frames still take their time on the wire, so bursts keep their length
+    run.bitErrors += run.channel.transmit(reinterpret_cast<uchar *>(wire.data()),
+                                          qint64(wire.size()) * 8, run.rng);
+    if (simulateDataLoss(run)) {
+        return ChannelResult::Lost;
+    }
+
+    // The receiver's only check: remove the framing and compare the payload
+    // with the sender's CRC. A damaged flag or escape can also change the
+    // payload length.
+    const QByteArray received = decodeFrame(run.framing, wire);
+    if (received.size() != frame.getDataSize()
+        || !CRC::verifyCRC16(received, frame.getCRCValue())) {
+        return ChannelResult::Corrupted;
+    }
+    return ChannelResult::Delivered;
+}
+
+void DataLinkWorker::recordDelivery(RunState &run, const Frame &frame, int position)
+{
+    // The receiver took frame as the one at position; with too few sequence
+    // numbers it can be an older or newer frame carrying the same number
+    if (frame.getFrameNumber() != position) {
+        run.misdeliveredFrames++;
+        return;
+    }
+    run.deliveredFrames++;
+    counters.add(LinkCounters::Successes);
+}
+
+void DataLinkWorker::countTransmission(RunState &run, bool retransmission)
+{
+    run.transmissions++;
+    counters.add(LinkCounters::Attempts);
+    if (retransmission) {
+        run.retransmissions++;
+        counters.add(LinkCounters::Retries);
+    }
+}
+
+void DataLinkWorker::reportFailure(RunState &run, Frame &frame)
+{
+    frame.setValid(false);
+    frame.addError(Frame::TransmissionFailed);
+    run.failedFrames++;
+    counters.add(LinkCounters::Failures);
+    if (run.reporting) {
+        publish(run, LinkEvent::FrameFailed, frame);
+    }
+}
+
+void DataLinkWorker::publish(RunState &run, LinkEvent::Kind kind, const Frame &frame)
+{
+    LinkEvent event;
+    event.time = run.scheduler.now();
+    event.frameIndex = frame.getFrameNumber();
+    event.kind = kind;
+    event.status = frame.getStatus();
+    event.attempts = static_cast<quint8>(frame.getAttempts());
+    event.sequence = static_cast<quint8>(event.frameIndex % run.sequenceModulus);
+    if (event.isOutcome()) {
+        run.frames.record(frame); // Handed over in full when the run ends
+    }
+
+    if (run.events) {
+        run.events->push(event); // Never waits; a full ring drops the event
+        return;
+    }
+    if (kind != LinkEvent::FrameDelivered) {
+        emit statusUpdate(EventChannel::describe(event));
+    }
+    if (event.isOutcome()) {
+        emit frameProcessed(frame);
+    }
+}
+
+void DataLinkWorker::reportThroughput(const RunState &run)
+{
+    // Goodput of this run on the simulated link, against the textbook
+    // stop-and-wait figure for the same channel: P(success) / (T_frame + RTT).
+    // The burst channel has no closed-form frame error rate, so the rate
+    // measured on the frames that were not lost stands in for it.
+    const double frameBits = run.frames.frameBitSize();
+    const double effective = run.simulatedMs > 0
+        ? run.deliveredFrames * frameBits / (run.simulatedMs / 1000.0) : 0.0;
+    const int arrivedFrames = run.transmissions - run.lostFrames;
+    const double corruptionRate = arrivedFrames > 0
+        ? static_cast<double>(run.corruptedFrames) / arrivedFrames : 0.0;
+    const double successProbability = (1.0 - LOSS_PROBABILITY) * (1.0 - corruptionRate)
+        * (1.0 - ACK_LOSS_PROBABILITY);
+    const double stopAndWait = successProbability * frameBits
+        / ((FRAME_TIME_MS + 2 * PROPAGATION_DELAY_MS) / 1000.0);
+
+    emit statusUpdate(QString("Simulated time: %1 s").arg(run.simulatedMs / 1000.0, 0, 'f', 3));
+    emit statusUpdate(QString("Effective throughput: %1 bit/s with %2 (window %3), stop-and-wait baseline %4 bit/s")
+        .arg(effective, 0, 'f', 1)
+        .arg(modeName(run.mode))
+        .arg(run.window)
+        .arg(stopAndWait, 0, 'f', 1));
+    emit throughputMeasured(effective, stopAndWait);
+
+    const double ratio = run.transmissions > 0
+        ? static_cast<double>(run.retransmissions) / run.transmissions : 0.0;
+    emit statusUpdate(QString("Retransmissions: %1 of %2 frames sent (%3%)")
+        .arg(run.retransmissions)
+        .arg(run.transmissions)
+        .arg(ratio * 100.0, 0, 'f', 1));
+    emit retransmissionsCounted(run.transmissions, run.retransmissions);
+
+    emit statusUpdate(QString("Burst channel: %1 bits flipped, %2 of %3 arriving frames corrupted (%4%)")
+        .arg(run.bitErrors)
+        .arg(run.corruptedFrames)
+        .arg(arrivedFrames)
+        .arg(corruptionRate * 100.0, 0, 'f', 1));
+
+    if (run.transmissions > 0) {
+        emit statusUpdate(QString("Framing: %1, %2 wire bytes per frame sent")
+            .arg(framingName(run.framing))
+            .arg(double(run.wireBytes) / run.transmissions, 0, 'f', 2));
+    }
+}
+
+QString DataLinkWorker::modeName(ArqMode mode)
+{
+    switch (mode) {
+    case ArqMode::GoBackN:
+        return "Go-Back-N";
+    case ArqMode::SelectiveRepeat:
+        return "Selective Repeat";
+    default:
+        return "Stop-and-Wait";
     }
+}
+
+QString DataLinkWorker::framingName(FramingMode mode)
+{
+    return mode == FramingMode::BitStuffing ? "HDLC bit stuffing" : "byte stuffing";
+}
+
+int DataLinkWorker::sequenceOffset(const RunState &run, int sequence, int index)
+{
+    return ((sequence - index % run.sequenceModulus) + run.sequenceModulus) % run.sequenceModulus;
+}
+
+int DataLinkWorker::sequenceModulusFor(int window)
+{
+    // Go-Back-N needs at least window + 1 distinct sequence numbers
+    int modulus = 2;
+    while (modulus <= window) {
+        modulus <<= 1;
+    }
+    return modulus;
+}
+
+void DataLinkWorker::setArqMode(ArqMode mode, int window)
+{
+    mutex.lock();
+    arqMode = mode;
+    windowSize = qMax(1, window);
+    mutex.unlock();
+}
+
+void DataLinkWorker::setFramingMode(FramingMode mode)
+{
+    mutex.lock();
+    framingMode = mode;
+    mutex.unlock();
+}
+
+void DataLinkWorker::setRealTime(bool enabled)
+{
+    mutex.lock();
+    realTime = enabled;
+    mutex.unlock();
+}
+
+LinkStats DataLinkWorker::statsSnapshot() const
+{
+    return counters.snapshot();
+}
+
+void DataLinkWorker::setEventChannel(EventChannel *channel)
+{
+    mutex.lock();
+    eventChannel = channel;
+    mutex.unlock();
+}
+
+void DataLinkWorker::setChannelParameters(const BurstChannel::Parameters &parameters)
+{
+    mutex.lock();
+    channelParameters = parameters;
+    mutex.unlock();
+}
+
+void DataLinkWorker::calculateChecksum(quint8 accum)
+{
     checksum = QString("%1").arg(accum, 2, 16, QChar('0')).toUpper();
     emit checksumCalculated(checksum);
 }
@@ -238,37 +679,36 @@ QString DataLinkWorker::escapeSpecialCharacters(const QString &data) const
     return result;
 }
 
-bool DataLinkWorker::simulateDataLoss()
-{
-    bool result = QRandomGenerator::global()->generateDouble() < 0.10; // 10% chance
-    qDebug() << "simulateDataLoss result:" << result;
-    return result;
-}
-
-bool DataLinkWorker::simulateDataCorruption()
+bool DataLinkWorker::simulateDataLoss(RunState &run)
 {
-    return QRandomGenerator::global()->generateDouble() < 0.20; // 20% chance
+    return run.frameLoss.next(run.rng);
 }
 
-bool DataLinkWorker::simulateAckLoss()
+bool DataLinkWorker::simulateAckLoss(RunState &run)
 {
-    return QRandomGenerator::global()->generateDouble() < 0.15; // 15% chance
+    return run.ackLoss.next(run.rng);
 }
 
-bool DataLinkWorker::simulateChecksumError()
+bool DataLinkWorker::simulateChecksumError(RunState &run)
 {
-    return QRandomGenerator::global()->generateDouble() < 0.05; // 5% chance
+    return run.checksumError.next(run.rng);
 }
 
 // DataLinkLayer Implementation
 DataLinkLayer::DataLinkLayer(QObject *parent)
     : QObject(parent)
     , transmitting(false)
+    , loadMode(LoadMode::Automatic)
+    , arqMode(ArqMode::StopAndWait)
+    , framingMode(FramingMode::ByteStuffing)
+    , windowSize(DataLinkWorker::DEFAULT_WINDOW_SIZE)
+    , realTime(false)
     , worker(new DataLinkWorker)
 {
     qDebug() << "Initializing DataLinkLayer...";
     
     // Move worker to thread before starting it
+    worker->setEventChannel(&events);
     worker->moveToThread(&workerThread);
 
     // Connect thread signals
@@ -278,8 +718,18 @@ DataLinkLayer::DataLinkLayer(QObject *parent)
     // Connect worker signals
     connect(worker, &DataLinkWorker::frameProcessed, this, [this](const Frame &frame) {
         qDebug() << "Frame processed signal received for frame" << frame.getFrameNumber();
+        mutex.lock();
+        store.record(frame);
+        mutex.unlock();
         emit frameProcessed(frame);
     });
+    connect(worker, &DataLinkWorker::framesRecorded, this, [this](const FrameStore &frames) {
+        mutex.lock();
+        if (frames.count() == store.count()) {
+            store = frames; // Shares the worker's status arrays
+        }
+        mutex.unlock();
+    });
     connect(worker, &DataLinkWorker::transmissionComplete, this, [this]() {
         qDebug() << "Transmission complete signal received";
         mutex.lock();
@@ -287,6 +737,7 @@ DataLinkLayer::DataLinkLayer(QObject *parent)
         mutex.unlock();
         emit transmissionComplete();
     });
+    connect(worker, &DataLinkWorker::transmissionStopped, this, &DataLinkLayer::transmissionStopped);
     connect(worker, &DataLinkWorker::errorOccurred, this, [this](const QString &error) {
         qDebug() << "Error occurred:" << error;
         mutex.lock();
@@ -295,6 +746,8 @@ DataLinkLayer::DataLinkLayer(QObject *parent)
         emit errorOccurred(error);
     });
     connect(worker, &DataLinkWorker::statusUpdate, this, &DataLinkLayer::statusUpdate);
+    connect(worker, &DataLinkWorker::throughputMeasured, this, &DataLinkLayer::throughputMeasured);
+    connect(worker, &DataLinkWorker::retransmissionsCounted, this, &DataLinkLayer::retransmissionsCounted);
     connect(worker, &DataLinkWorker::checksumCalculated, this, [this](const QString &value) {
         mutex.lock();
         checksum = value;
@@ -331,80 +784,214 @@ bool DataLinkLayer::loadFile(const QString &filePath)
         return false;
     }
 
+    const bool useMapping = loadMode == LoadMode::Mapped
+        || (loadMode == LoadMode::Automatic && file.size() >= MAPPED_LOAD_THRESHOLD);
+
     mutex.lock();
     currentFilePath = filePath;
-    QByteArray fileData = file.readAll();
-    file.close();
 
     // Clear previous frames
-    frames.clear();
+    store.clear();
     checksum.clear();
     checksumFrame.clear();
 
-    // Convert file data to bits
-    QBitArray bits(fileData.size() * 8);
-    for(int i = 0; i < fileData.size(); ++i) {
-        for(int b = 0; b < 8; ++b) {
-            bits.setBit(i * 8 + b, fileData.at(i) & (1 << (7 - b)));
+    if (useMapping) {
+        // Large inputs stay on disk; frames are cut from the mapping when asked for
+        file.close();
+        QSharedPointer<FrameSource> mappedSource(new FrameSource);
+        if (!mappedSource->open(filePath)) {
+            worker->setData(store);
+            mutex.unlock();
+            emit errorOccurred("Failed to map file");
+            return false;
         }
+        store.attach(mappedSource);
+        worker->setData(store);
+        const int count = store.count();
+        mutex.unlock();
+
+        emit statusUpdate(QString("File mapped: %1 frames available").arg(count));
+        return true;
     }
 
-    // Split into 100-bit frames
-    const int frameBitSize = 100; // Exactly 100 bits per frame
-    int totalFrames = (bits.count() + frameBitSize - 1) / frameBitSize;
-
-    for(int i = 0; i < totalFrames; ++i) {
-        // Calculate how many bits remain for this frame
-        int remainingBits = qMin(frameBitSize, bits.count() - i * frameBitSize);
-        
-        // Create a byte array to hold this frame's data
-        QByteArray frameData((frameBitSize + 7) / 8, 0); // Always allocate space for 100 bits
-        
-        // Copy bits to the frame data
-        for(int j = 0; j < remainingBits; ++j) {
-            if(bits.testBit(i * frameBitSize + j)) {
-                int byteIndex = j / 8;
-                int bitIndex = 7 - (j % 8);
-                frameData[byteIndex] |= (1 << bitIndex);
-            }
-        }
+    // Cut the frames outside the lock, straight from a mapping of the file
+    // when possible. Until the new store is swapped in there are no frames.
+    worker->setData(store);
+    mutex.unlock();
 
-        // Create frame and set its properties
-        Frame frame(frameData);
-        frame.setFrameNumber(i);
-        
-        // Handle padding for the last frame
-        if (remainingBits < frameBitSize) {
-            frame.setLastFrame(true);
-            frame.setHasPadding(true);
-            frame.setBitCount(frameBitSize); // Set to 100 bits after padding
-            
-            // Add padding bits (0s)
-            for(int j = remainingBits; j < frameBitSize; ++j) {
-                int byteIndex = j / 8;
-                int bitIndex = 7 - (j % 8);
-                frameData[byteIndex] &= ~(1 << bitIndex); // Set padding bit to 0
-            }
-            
-            emit statusUpdate(QString("Partial frame detected: Frame %1 padded to %2 bits").arg(i).arg(frameBitSize));
-        } else {
-            frame.setBitCount(frameBitSize);
-        }
-        
-        frames.append(frame);
+    FrameStore loaded;
+    const qint64 fileSize = file.size();
+    uchar *mapped = fileSize > 0 ? file.map(0, fileSize) : nullptr;
+    if (mapped) {
+        loaded.load(mapped, fileSize);
+        file.unmap(mapped);
+    } else {
+        loaded.load(file.readAll());
     }
+    file.close();
 
-    worker->setData(frames);
+    mutex.lock();
+    store = loaded;
+    worker->setData(store);
+    const int count = store.count();
+    const bool partial = store.hasPartialFrame();
+    const int frameBits = store.frameBitSize();
     mutex.unlock();
-    
-    emit statusUpdate(QString("File loaded: %1 frames created").arg(frames.size()));
+
+    if (partial) {
+        emit statusUpdate(QString("Partial frame detected: Frame %1 padded to %2 bits")
+            .arg(count - 1).arg(frameBits));
+    }
+    emit statusUpdate(QString("File loaded: %1 frames created").arg(count));
     return true;
 }
 
+int DataLinkLayer::frameCount() const
+{
+    mutex.lock();
+    int result = store.count();
+    mutex.unlock();
+    return result;
+}
+
+Frame DataLinkLayer::frameAt(int index) const
+{
+    mutex.lock();
+    Frame result = store.frame(index);
+    mutex.unlock();
+    return result;
+}
+
+int DataLinkLayer::countFrames(quint8 statusMask) const
+{
+    mutex.lock();
+    int result = store.countWithStatus(statusMask);
+    mutex.unlock();
+    return result;
+}
+
+int DataLinkLayer::takeEvents(LinkEvent *out, int maxEvents)
+{
+    const int count = events.drain(out, maxEvents);
+    mutex.lock();
+    for (int i = 0; i < count; ++i) {
+        if (out[i].isOutcome()) {
+            store.record(out[i].frameIndex, out[i].status, out[i].attempts);
+        }
+    }
+    mutex.unlock();
+    return count;
+}
+
+FrameStore DataLinkLayer::frameStore() const
+{
+    mutex.lock();
+    FrameStore result = store;
+    mutex.unlock();
+    return result;
+}
+
+LinkStats DataLinkLayer::statsSnapshot() const
+{
+    // The worker only lives on its thread; its counters are safe to read here
+    return worker->statsSnapshot();
+}
+
+qint64 DataLinkLayer::droppedEvents() const
+{
+    return events.dropped();
+}
+
+void DataLinkLayer::setLoadMode(LoadMode mode)
+{
+    mutex.lock();
+    loadMode = mode;
+    mutex.unlock();
+}
+
+DataLinkLayer::LoadMode DataLinkLayer::getLoadMode() const
+{
+    mutex.lock();
+    LoadMode result = loadMode;
+    mutex.unlock();
+    return result;
+}
+
+void DataLinkLayer::setArqMode(ArqMode mode)
+{
+    mutex.lock();
+    arqMode = mode;
+    mutex.unlock();
+}
+
+ArqMode DataLinkLayer::getArqMode() const
+{
+    mutex.lock();
+    ArqMode result = arqMode;
+    mutex.unlock();
+    return result;
+}
+
+void DataLinkLayer::setWindowSize(int size)
+{
+    mutex.lock();
+    windowSize = qBound(1, size, DataLinkWorker::MAX_WINDOW_SIZE);
+    mutex.unlock();
+}
+
+int DataLinkLayer::getWindowSize() const
+{
+    mutex.lock();
+    int result = windowSize;
+    mutex.unlock();
+    return result;
+}
+
+void DataLinkLayer::setFramingMode(FramingMode mode)
+{
+    mutex.lock();
+    framingMode = mode;
+    mutex.unlock();
+}
+
+FramingMode DataLinkLayer::getFramingMode() const
+{
+    mutex.lock();
+    FramingMode result = framingMode;
+    mutex.unlock();
+    return result;
+}
+
+void DataLinkLayer::setRealTime(bool enabled)
+{
+    mutex.lock();
+    realTime = enabled;
+    mutex.unlock();
+}
+
+bool DataLinkLayer::isRealTime() const
+{
+    mutex.lock();
+    bool result = realTime;
+    mutex.unlock();
+    return result;
+}
+
+MonteCarloRunner DataLinkLayer::monteCarloRunner() const
+{
+    MonteCarloRunner runner;
+    mutex.lock();
+    runner.setData(store);
+    runner.setArqMode(arqMode, windowSize);
+    runner.setFramingMode(framingMode);
+    mutex.unlock();
+    return runner;
+}
+
 QVector<Frame> DataLinkLayer::getFrames() const
 {
     mutex.lock();
-    QVector<Frame> result = frames;
+    QVector<Frame> result = store.toFrames();
     mutex.unlock();
     return result;
 }
@@ -436,13 +1023,17 @@ void DataLinkLayer::startTransmission()
     }
 
     mutex.lock();
-    if (frames.isEmpty()) {
+    if (store.isEmpty()) {
         mutex.unlock();
         qDebug() << "No frames to transmit";
         emit errorOccurred("No frames to transmit");
         return;
     }
     transmitting = true;
+    store.resetStatuses(); // Rows and timeline start out pending
+    worker->setArqMode(arqMode, windowSize);
+    worker->setFramingMode(framingMode);
+    worker->setRealTime(realTime);
     mutex.unlock();
 
     qDebug() << "Invoking process method in worker thread";
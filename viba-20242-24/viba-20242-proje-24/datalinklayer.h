@@ -3,52 +3,221 @@
 
 #include <QObject>
 #include <QVector>
+#include <QMap>
+#include <QSet>
 #include <QString>
 #include <QThread>
 #include <QMutex>
+#include <QSharedPointer>
 #include "frame.h"
-
-// Frame flags and escape character definitions
-#define FRAME_FLAG 0x7E
-#define ESCAPE_CHAR 0x7D
+#include "framestore.h"
+#include "eventscheduler.h"
+#include "bytestuffing.h"
+#include "bitstuffing.h"
+#include "eventchannel.h"
+#include "linkcounters.h"
+#include "burstchannel.h"
+#include "channelrng.h"
 
 // Special header for checksum frame
 #define CHECKSUM_HEADER "CHK"
 
+class MonteCarloRunner;
+
+// Retransmission scheme used by the worker
+enum class ArqMode {
+    StopAndWait,
+    GoBackN,
+    SelectiveRepeat
+};
+
+// How frames are delimited on the simulated wire
+enum class FramingMode {
+    ByteStuffing, // 0x7E flags, 0x7D escapes, whole 13-byte payloads
+    BitStuffing   // HDLC: 01111110 flags, 0 after five 1s, exactly 100 bits
+};
+
 class DataLinkWorker : public QObject
 {
     Q_OBJECT
 
 public:
     explicit DataLinkWorker(QObject *parent = nullptr);
-    void setData(const QVector<Frame>& newFrames);
+    void setData(const FrameStore &newStore);
+    void setArqMode(ArqMode mode, int window);
+    void setFramingMode(FramingMode mode);
+    // Pace events to the virtual clock in wall time, for demos
+    void setRealTime(bool enabled);
+    // Per-frame updates go into this ring instead of queued signals. The
+    // channel must outlive the worker; null restores the signals.
+    void setEventChannel(EventChannel *channel);
+    // Burst error model the wire bits go through on the next run
+    void setChannelParameters(const BurstChannel::Parameters &parameters);
+    // Counters of the current or last run; wait-free from any thread
+    LinkStats statsSnapshot() const;
+
+    // Outcome of one silent run on the virtual clock
+    struct TrialResult {
+        quint64 seed = 0;
+        int deliveredFrames = 0;
+        int failedFrames = 0;
+        int transmissions = 0;
+        int retransmissions = 0;
+        int lostFrames = 0;
+        int corruptedFrames = 0;
+        int ackLosses = 0;
+        int misdeliveredFrames = 0; // Taken for another frame with the same sequence number
+        int skipNotices = 0; // Sent to tell the receiver to stop waiting for a failed frame
+        qint64 wireBytes = 0; // Framed bytes put on the wire, resends included
+        qint64 bitErrors = 0; // Wire bits flipped by the channel
+        qint64 simulatedMs = 0;
+        double goodput = 0.0; // Delivered bits per simulated second
+    };
+
+    // Runs the loaded frames once with the channel drawn from seed, without
+    // emitting anything. The same seed always gives the same result.
+    // Safe to call on separate workers from several threads.
+    TrialResult runTrial(quint64 seed);
+
+    // Flag-delimited byte stuffing as sent on the simulated wire
+    static QByteArray applyByteStuffing(const QByteArray &data);
+    static QByteArray removeByteStuffing(const QByteArray &stuffedData);
+    // A frame as sent with the given framing, and the payload recovered from it
+    static QByteArray encodeFrame(FramingMode framing, const Frame &frame);
+    static QByteArray decodeFrame(FramingMode framing, const QByteArray &wire);
+
+    static const int DEFAULT_WINDOW_SIZE = 7;
+    static const int MAX_WINDOW_SIZE = 127;
 
 public slots:
     void process();
 
 signals:
     void frameProcessed(const Frame &frame);
+    // Final status of every frame once a run ends, whatever the channel dropped
+    void framesRecorded(const FrameStore &frames);
     void transmissionComplete();
+    // The run was interrupted; sent after framesRecorded
+    void transmissionStopped();
     void errorOccurred(const QString &error);
     void statusUpdate(const QString &status);
     void checksumCalculated(const QString &checksum);
     void checksumFrameSent(const QString &checksumFrame);
+    // Delivered payload bits per simulated second, next to the stop-and-wait figure
+    void throughputMeasured(double effectiveBitsPerSecond, double stopAndWaitBitsPerSecond);
+    // Frames put on the wire, and how many of those were resends
+    void retransmissionsCounted(int transmissions, int retransmissions);
 
 private:
-    QVector<Frame> frames;
+    // Simulated link: time to put one frame on the wire and one-way delay.
+    // A frame's timer expires one frame time plus one round trip after it
+    // went out, which is exactly when its ACK would arrive.
+    static const int FRAME_TIME_MS = 10;
+    static const int PROPAGATION_DELAY_MS = 50;
+
+    // Channel error model; corruption comes from the burst channel's bit errors
+    static constexpr double LOSS_PROBABILITY = 0.10;
+    static constexpr double ACK_LOSS_PROBABILITY = 0.15;
+    static constexpr double CHECKSUM_ERROR_PROBABILITY = 0.05;
+
+    enum class ChannelResult {
+        Delivered,
+        Lost,
+        Corrupted
+    };
+
+    // Sender-side state of one frame in the window
+    struct PendingFrame {
+        Frame frame;
+        int generation = 0; // Bumped per send or skip notice; older timers are stale
+        int timeouts = 0;
+        bool sent = false;
+        bool acked = false;
+        bool failed = false;
+    };
+
+    // State of one run, driven by events on the virtual clock. The sender
+    // window covers frames [base, base + outstanding.size()).
+    struct RunState {
+        FrameStore frames;
+        ArqMode mode = ArqMode::StopAndWait;
+        FramingMode framing = FramingMode::ByteStuffing;
+        int window = 1;
+        int sequenceModulus = 2;
+        bool realTime = false;
+        bool reporting = true; // Emit per-frame signals and log lines
+        EventChannel *events = nullptr; // Per-frame updates while reporting
+        ChannelRng rng;
+        BurstChannel channel;
+        BernoulliStream frameLoss;
+        BernoulliStream ackLoss;
+        BernoulliStream checksumError;
+
+        EventScheduler scheduler;
+        QVector<PendingFrame> outstanding;
+        QVector<int> retransmitQueue;
+        QMap<int, Frame> reorderBuffer; // Frames held until all before them arrived, keyed by sequence number
+        QSet<int> skippedSequences; // Skip notices inside the receive window, not yet stepped over
+        int base = 0;
+        int expected = 0;
+        bool linkBusy = false;
+
+        quint8 checksumAccumulator = 0;
+        int deliveredFrames = 0;
+        int transmissions = 0;
+        int retransmissions = 0;
+        int lostFrames = 0;
+        int corruptedFrames = 0;
+        int ackLosses = 0;
+        int misdeliveredFrames = 0;
+        int skipNotices = 0;
+        int failedFrames = 0;
+        qint64 wireBytes = 0;
+        qint64 bitErrors = 0;
+        qint64 simulatedMs = 0;
+    };
+
+    FrameStore store;
+    ArqMode arqMode;
+    FramingMode framingMode;
+    int windowSize;
+    bool realTime;
+    EventChannel *eventChannel;
+    BurstChannel::Parameters channelParameters;
+    LinkCounters counters;
     QString checksum;
     QString checksumFrame;
     QMutex mutex;
 
-    void calculateChecksum();
+    void prepareRun(RunState &run, quint64 seed);
+    bool processSlidingWindow(RunState &run);
+    void startNextTransmission(RunState &run);
+    void handleFrameArrival(RunState &run, const EventScheduler::Event &event);
+    void handleSkipArrival(RunState &run, const EventScheduler::Event &event);
+    void handleAckArrival(RunState &run, const EventScheduler::Event &event);
+    void handleTimeout(RunState &run, const EventScheduler::Event &event);
+    void sendAck(RunState &run, int index, int ack);
+    void sendSkipNotice(RunState &run, int index);
+    void deliverInOrder(RunState &run);
+    void slideWindow(RunState &run);
+    void countTransmission(RunState &run, bool retransmission);
+    ChannelResult sendOverChannel(RunState &run, const Frame &frame);
+    void recordDelivery(RunState &run, const Frame &frame, int position);
+    void reportFailure(RunState &run, Frame &frame);
+    void publish(RunState &run, LinkEvent::Kind kind, const Frame &frame);
+    void reportThroughput(const RunState &run);
+    static QString modeName(ArqMode mode);
+    static QString framingName(FramingMode mode);
+    // How many frames past index the sequence number lies, modulo the sequence space
+    static int sequenceOffset(const RunState &run, int sequence, int index);
+    static int sequenceModulusFor(int window);
+
+    void calculateChecksum(quint8 accum);
     QString prepareChecksumFrame() const;
     QString escapeSpecialCharacters(const QString &data) const;
-    QByteArray applyByteStuffing(const QByteArray &data) const;
-    QByteArray removeByteStuffing(const QByteArray &stuffedData) const;
-    bool simulateDataLoss();
-    bool simulateDataCorruption();
-    bool simulateAckLoss();
-    bool simulateChecksumError(); // Only keep the bool version
+    bool simulateDataLoss(RunState &run);
+    bool simulateAckLoss(RunState &run);
+    bool simulateChecksumError(RunState &run); // Only keep the bool version
 };
 
 class DataLinkLayer : public QObject
@@ -56,11 +225,50 @@ class DataLinkLayer : public QObject
     Q_OBJECT
 
 public:
+    // How loadFile reads its input: fully into memory, memory-mapped with
+    // frames cut on demand, or mapped only from MAPPED_LOAD_THRESHOLD upwards
+    enum class LoadMode {
+        InMemory,
+        Mapped,
+        Automatic
+    };
+
+    static const qint64 MAPPED_LOAD_THRESHOLD = 64 * 1024 * 1024;
+
     explicit DataLinkLayer(QObject *parent = nullptr);
     ~DataLinkLayer();
 
     // File operations
     bool loadFile(const QString &filePath);
+    void setLoadMode(LoadMode mode);
+    LoadMode getLoadMode() const;
+    // Retransmission scheme and sliding window size for the next transmission
+    void setArqMode(ArqMode mode);
+    ArqMode getArqMode() const;
+    void setWindowSize(int size);
+    int getWindowSize() const;
+    // Framing used on the simulated wire for the next transmission
+    void setFramingMode(FramingMode mode);
+    FramingMode getFramingMode() const;
+    // Virtual time (default) runs at CPU speed; real time paces it for demos
+    void setRealTime(bool enabled);
+    bool isRealTime() const;
+    // Trial runner over the loaded frames with the current ARQ settings
+    MonteCarloRunner monteCarloRunner() const;
+    int frameCount() const;
+    Frame frameAt(int index) const;
+    // Number of frames whose status has any of the bits in mask set
+    int countFrames(quint8 statusMask) const;
+    // Moves up to maxEvents pending transmission events into out and records
+    // the frame statuses they carry. Call from the GUI thread only.
+    int takeEvents(LinkEvent *out, int maxEvents);
+    // Shared snapshot of the loaded frames and their recorded statuses
+    FrameStore frameStore() const;
+    // Live transmission counters; never locks and never touches frames
+    LinkStats statsSnapshot() const;
+    // Events the worker dropped because the GUI fell behind
+    qint64 droppedEvents() const;
+    // Empty for memory-mapped files; use frameCount()/frameAt() instead
     QVector<Frame> getFrames() const;
     QString getChecksum() const;
     QString getChecksumFrame() const;
@@ -73,18 +281,29 @@ public:
 signals:
     void frameProcessed(const Frame &frame);
     void transmissionComplete();
+    // The worker has left a run stopped with stopTransmission()
+    void transmissionStopped();
     void errorOccurred(const QString &error);
     void statusUpdate(const QString &status);
     void checksumCalculated(const QString &checksum);
     void checksumFrameSent(const QString &checksumFrame);
+    void throughputMeasured(double effectiveBitsPerSecond, double stopAndWaitBitsPerSecond);
+    // Frames put on the wire, and how many of those were resends
+    void retransmissionsCounted(int transmissions, int retransmissions);
 
 private:
-    QVector<Frame> frames;
+    FrameStore store;
     QString checksum;
     QString checksumFrame;
     bool transmitting;
+    LoadMode loadMode;
+    ArqMode arqMode;
+    FramingMode framingMode;
+    int windowSize;
+    bool realTime;
     QString currentFilePath;
     
+    EventChannel events;
     QThread workerThread;
     DataLinkWorker* worker;
     mutable QMutex mutex;
@@ -0,0 +1,129 @@
+#include "deframer.h"
+#include "bytestuffing.h"
+#include <cstring>
+
+Deframer::Deframer(FrameHandler handler, qsizetype maxFrameSize)
+    : handler(std::move(handler))
+    , maxFrameSize(maxFrameSize)
+    , frameLength(0)
+    , wireLength(0)
+    , hunting(true)
+    , escaped(false)
+    , frames(0)
+    , consumed(0)
+    , discarded(0)
+    , oversized(0)
+    , aborted(0)
+{
+}
+
+void Deframer::feed(const QByteArray &chunk)
+{
+    feed(chunk.constData(), chunk.size());
+}
+
+void Deframer::feed(const char *data, qsizetype size)
+{
+    const uchar *pos = reinterpret_cast<const uchar *>(data);
+    const uchar *const end = pos + size;
+    consumed += size;
+
+    while (pos < end) {
+        const uchar *flag = static_cast<const uchar *>(memchr(pos, FRAME_FLAG, end - pos));
+
+        if (hunting) {
+            if (!flag) {
+                discarded += end - pos;
+                return;
+            }
+            discarded += flag - pos;
+            hunting = false;
+            pos = flag + 1;
+            continue;
+        }
+
+        const uchar *const spanEnd = flag ? flag : end;
+        const qsizetype span = spanEnd - pos;
+
+        // A frame that opens and closes inside this chunk with no escapes
+        // is handed over in place
+        if (flag && wireLength == 0 && span <= maxFrameSize && !memchr(pos, ESCAPE_CHAR, span)) {
+            deliver(reinterpret_cast<const char *>(pos), span);
+            pos = flag + 1;
+            continue;
+        }
+
+        if (wireLength + span > maxFrameSize) {
+            wireLength = maxFrameSize + 1; // Dropped at the closing flag
+        } else {
+            if (buffer.size() < maxFrameSize + 1) {
+                buffer.resize(maxFrameSize + 1);
+            }
+            uchar *out = reinterpret_cast<uchar *>(buffer.data()) + frameLength;
+            frameLength += ByteStuffing::destuffSpan(pos, span, out, escaped);
+            wireLength += span;
+        }
+
+        if (!flag) {
+            return;
+        }
+        closeFrame();
+        pos = flag + 1;
+    }
+}
+
+void Deframer::reset()
+{
+    frameLength = 0;
+    wireLength = 0;
+    hunting = true;
+    escaped = false;
+}
+
+void Deframer::deliver(const char *data, qsizetype length)
+{
+    // Back-to-back flags delimit nothing
+    if (length > 0) {
+        frames++;
+        handler(QByteArray::fromRawData(data, length));
+    }
+}
+
+void Deframer::closeFrame()
+{
+    if (wireLength > maxFrameSize) {
+        oversized++;
+    } else if (escaped) {
+        aborted++;
+    } else {
+        deliver(buffer.constData(), frameLength);
+    }
+    frameLength = 0;
+    wireLength = 0;
+    escaped = false;
+}
+
+qint64 Deframer::framesDecoded() const
+{
+    return frames;
+}
+
+qint64 Deframer::bytesConsumed() const
+{
+    return consumed;
+}
+
+qint64 Deframer::bytesDiscarded() const
+{
+    return discarded;
+}
+
+qint64 Deframer::oversizedFrames() const
+{
+    return oversized;
+}
+
+qint64 Deframer::abortedFrames() const
+{
+    return aborted;
+}
@@ -0,0 +1,57 @@
+#ifndef DEFRAMER_H
+#define DEFRAMER_H
+
+#include <QByteArray>
+#include <functional>
+
+// Resumable receiver for a continuous stream of flag-delimited, byte-stuffed
+// frames, as written by ByteStuffing::stuff. Chunks may be cut anywhere: an
+// open frame and a pending escape are carried over to the next feed() call.
+// Memory use is bounded by the largest accepted frame, whatever the stream
+// length.
+class Deframer
+{
+public:
+    // Receives each decoded frame. The array is a view that is only valid
+    // during the call: a frame that arrived whole and without escapes points
+    // into the caller's chunk, anything else into the deframer's buffer.
+    using FrameHandler = std::function<void(const QByteArray &frame)>;
+
+    static const qsizetype DEFAULT_MAX_FRAME_SIZE = 64 * 1024;
+
+    // Frames longer than maxFrameSize bytes on the wire are dropped
+    explicit Deframer(FrameHandler handler, qsizetype maxFrameSize = DEFAULT_MAX_FRAME_SIZE);
+
+    void feed(const char *data, qsizetype size);
+    void feed(const QByteArray &chunk);
+    // Forgets any partial frame and waits for the next flag
+    void reset();
+
+    qint64 framesDecoded() const;
+    qint64 bytesConsumed() const;
+    // Bytes seen before the first flag or after a reset
+    qint64 bytesDiscarded() const;
+    qint64 oversizedFrames() const;
+    // Frames closed by a flag right after an escape (the HDLC abort sequence)
+    qint64 abortedFrames() const;
+
+private:
+    void deliver(const char *data, qsizetype length);
+    void closeFrame();
+
+    FrameHandler handler;
+    qsizetype maxFrameSize;
+    QByteArray buffer;
+    qsizetype frameLength; // Decoded bytes of the open frame in buffer
+    qsizetype wireLength;  // Stuffed bytes of the open frame so far
+    bool hunting;          // No flag seen yet
+    bool escaped;
+
+    qint64 frames;
+    qint64 consumed;
+    qint64 discarded;
+    qint64 oversized;
+    qint64 aborted;
+};
+
+#endif // DEFRAMER_H
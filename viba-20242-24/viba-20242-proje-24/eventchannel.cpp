@@ -0,0 +1,93 @@
+#include "eventchannel.h"
+#include "frame.h"
+#include <cstring>
+
+bool LinkEvent::isOutcome() const
+{
+    return kind == FrameDelivered || kind == FrameFailed;
+}
+
+EventChannel::EventChannel(int capacity)
+    : mask(0)
+    , head(0)
+    , cachedTail(0)
+    , tail(0)
+    , droppedEvents(0)
+{
+    int size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    ring.resize(size);
+    buffer = ring.data(); // Never resized again, so never detached
+    mask = quint64(size - 1);
+}
+
+bool EventChannel::push(const LinkEvent &event)
+{
+    const quint64 position = head.load(std::memory_order_relaxed);
+    if (position - cachedTail > mask) {
+        cachedTail = tail.load(std::memory_order_acquire);
+        if (position - cachedTail > mask) {
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    buffer[position & mask] = event;
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+int EventChannel::drain(LinkEvent *out, int maxEvents)
+{
+    const quint64 position = tail.load(std::memory_order_relaxed);
+    const quint64 available = head.load(std::memory_order_acquire) - position;
+    const int count = static_cast<int>(qMin<quint64>(available, quint64(qMax(0, maxEvents))));
+    if (count == 0) {
+        return 0;
+    }
+
+    // At most two contiguous runs, split where the ring wraps
+    const int start = static_cast<int>(position & mask);
+    const int first = qMin(count, static_cast<int>(mask + 1) - start);
+    std::memcpy(out, buffer + start, first * sizeof(LinkEvent));
+    std::memcpy(out + first, buffer, (count - first) * sizeof(LinkEvent));
+    tail.store(position + count, std::memory_order_release);
+    return count;
+}
+
+int EventChannel::capacity() const
+{
+    return static_cast<int>(mask + 1);
+}
+
+qint64 EventChannel::dropped() const
+{
+    return droppedEvents.load(std::memory_order_relaxed);
+}
+
+QString EventChannel::describe(const LinkEvent &event)
+{
+    switch (event.kind) {
+    case LinkEvent::FrameLost:
+    case LinkEvent::FrameCorrupted:
+        return QString("Frame %1 (seq %2) %3 during transmission (Attempt %4)")
+            .arg(event.frameIndex)
+            .arg(event.sequence)
+            .arg(event.kind == LinkEvent::FrameLost ? "lost" : "corrupted")
+            .arg(event.attempts);
+    case LinkEvent::FrameDelivered:
+        return QString("Frame %1 (seq %2) delivered to the receiver").arg(event.frameIndex).arg(event.sequence);
+    case LinkEvent::AckLost:
+        return QString("ACK lost for frame %1 (seq %2) (Attempt %3)")
+            .arg(event.frameIndex)
+            .arg(event.sequence)
+            .arg(event.attempts);
+    case LinkEvent::FrameAcked:
+        return QString("Frame %1 successfully transmitted and acknowledged").arg(event.frameIndex);
+    case LinkEvent::FrameFailed:
+        return QString("Frame %1 transmission failed after %2 timeouts").arg(event.frameIndex).arg(Frame::MAX_ATTEMPTS);
+    default:
+        return QString("Frame %1: unknown event %2").arg(event.frameIndex).arg(event.kind);
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef EVENTCHANNEL_H
+#define EVENTCHANNEL_H
+
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+// One step of a transmission as the GUI sees it: 16 bytes, no heap data
+struct LinkEvent {
+    enum Kind : quint8 {
+        FrameLost,
+        FrameCorrupted,
+        FrameDelivered,
+        AckLost,
+        FrameAcked,
+        FrameFailed
+    };
+
+    qint64 time;       // Virtual clock in ms
+    qint32 frameIndex;
+    quint8 kind;
+    quint8 status;     // Frame::StatusFlag bits after the event
+    quint8 attempts;
+    quint8 sequence;
+
+    // Delivered and failed frames have a final status
+    bool isOutcome() const;
+};
+
+// Lock-free single-producer/single-consumer ring of LinkEvents from the
+// worker thread to the GUI thread. The worker never waits: when the GUI
+// falls behind and the ring is full, events are counted and dropped. The
+// GUI drains it in batches.
+class EventChannel
+{
+public:
+    static const int DEFAULT_CAPACITY = 1 << 16;
+
+    // Capacity is rounded up to a power of two
+    explicit EventChannel(int capacity = DEFAULT_CAPACITY);
+
+    // Producer side only
+    bool push(const LinkEvent &event);
+    // Consumer side only: moves up to maxEvents into out, oldest first
+    int drain(LinkEvent *out, int maxEvents);
+
+    int capacity() const;
+    qint64 dropped() const;
+
+    // Log line for an event, as the worker's status messages read
+    static QString describe(const LinkEvent &event);
+
+private:
+    QVector<LinkEvent> ring;
+    LinkEvent *buffer;
+    quint64 mask;
+
+    // Producer and consumer indices on separate cache lines. Each side keeps
+    // a stale copy of the other's index and refreshes it only when needed.
+    alignas(64) std::atomic<quint64> head;
+    quint64 cachedTail;
+    alignas(64) std::atomic<quint64> tail;
+    alignas(64) std::atomic<qint64> droppedEvents;
+};
+
+#endif // EVENTCHANNEL_H
@@ -0,0 +1,60 @@
+#include "eventscheduler.h"
+
+EventScheduler::EventScheduler()
+    : clock(0)
+    , nextSequence(0)
+{
+}
+
+void EventScheduler::clear()
+{
+    queue = std::priority_queue<Event, std::vector<Event>, Later>();
+    clock = 0;
+    nextSequence = 0;
+}
+
+void EventScheduler::schedule(qint64 delay, EventType type, int frameIndex, int tag)
+{
+    Event event;
+    event.time = clock + delay;
+    event.sequence = nextSequence++;
+    event.type = type;
+    event.frameIndex = frameIndex;
+    event.tag = tag;
+    queue.push(event);
+}
+
+EventScheduler::Event EventScheduler::takeNext()
+{
+    Event event = queue.top();
+    queue.pop();
+    clock = event.time;
+    return event;
+}
+
+bool EventScheduler::isEmpty() const
+{
+    return queue.empty();
+}
+
+int EventScheduler::pending() const
+{
+    return static_cast<int>(queue.size());
+}
+
+qint64 EventScheduler::now() const
+{
+    return clock;
+}
+
+bool EventScheduler::Later::operator()(const Event &a, const Event &b) const
+{
+    // Min-heap on (time, type, insertion order)
+    if (a.time != b.time) {
+        return a.time > b.time;
+    }
+    if (a.type != b.type) {
+        return a.type > b.type;
+    }
+    return a.sequence > b.sequence;
+}
@@ -0,0 +1,53 @@
+#ifndef EVENTSCHEDULER_H
+#define EVENTSCHEDULER_H
+
+#include <QtGlobal>
+#include <queue>
+#include <vector>
+
+// Discrete-event queue with a virtual clock in milliseconds. Events are
+// taken in time order; taking one moves the clock to its timestamp, so a
+// simulated run costs only the work done per event, never wall time.
+class EventScheduler
+{
+public:
+    // At equal timestamps events are taken in this order, so an ACK that
+    // arrives exactly when a timer expires still counts
+    enum EventType : quint8 {
+        FrameArrival,
+        SkipArrival, // The sender gave up on a frame; the receiver stops waiting for it
+        AckArrival,
+        TransmitComplete,
+        Timeout
+    };
+
+    struct Event {
+        qint64 time;
+        quint64 sequence;
+        EventType type;
+        int frameIndex;
+        int tag; // Sequence number of a frame, skip notice or ACK, or timer generation
+    };
+
+    EventScheduler();
+
+    void clear();
+    // Schedules an event delay milliseconds after the current time
+    void schedule(qint64 delay, EventType type, int frameIndex, int tag = 0);
+    Event takeNext();
+
+    bool isEmpty() const;
+    int pending() const;
+    qint64 now() const;
+
+private:
+    struct Later {
+        bool operator()(const Event &a, const Event &b) const;
+    };
+
+    std::priority_queue<Event, std::vector<Event>, Later> queue;
+    qint64 clock;
+    quint64 nextSequence;
+};
+
+#endif // EVENTSCHEDULER_H
@@ -4,35 +4,69 @@
 #include <QStringBuilder>
 
 Frame::Frame()
-    : frameNumber(-1)
-    , valid(true)
+    : offset(0)
+    , length(0)
+    , frameNumber(-1)
     , bitCount(0)
-    , lastFrame(false)
-    , hasPadding(false)
+    , crc(0)
+    , status(0)
+    , attempts(0)
 {
 }
 
 Frame::Frame(const QByteArray &data)
-    : data(data)
+    : buffer(data)
+    , offset(0)
+    , length(data.size())
     , frameNumber(-1)
-    , valid(true)
     , bitCount(data.size() * 8)
-    , lastFrame(false)
-    , hasPadding(false)
+    , crc(0)
+    , status(0)
+    , attempts(0)
 {
     calculateCRC();
 }
 
+Frame::Frame(const QByteArray &buffer, qsizetype offset, int length)
+    : buffer(buffer)
+    , offset(offset)
+    , length(length)
+    , frameNumber(-1)
+    , bitCount(length * 8)
+    , crc(0)
+    , status(0)
+    , attempts(0)
+{
+}
+
 Frame::~Frame()
 {
 }
 
 QByteArray Frame::getData() const
 {
-    return data;
+    if (offset == 0 && length == buffer.size()) {
+        return buffer;
+    }
+    return buffer.mid(offset, length);
+}
+
+const char *Frame::getConstData() const
+{
+    return buffer.constData() + offset;
+}
+
+int Frame::getDataSize() const
+{
+    return length;
 }
 
 QString Frame::getCRC() const
+{
+    return CRC::formatCRC16(crc);
+}
+
+quint16 Frame::getCRCValue() const
 {
     return crc;
 }
@@ -44,7 +78,7 @@ int Frame::getFrameNumber() const
 
 bool Frame::isValid() const
 {
-    return valid;
+    return !(status & Invalid);
 }
 
 int Frame::getBitCount() const
@@ -54,10 +88,19 @@ int Frame::getBitCount() const
 
 void Frame::setData(const QByteArray &newData)
 {
-    data = newData;
+    buffer = newData;
+    offset = 0;
+    length = newData.size();
 }
 
 void Frame::setCRC(const QString &newCRC)
+{
+    bool ok;
+    quint16 value = newCRC.toUShort(&ok, 16);
+    crc = ok ? value : 0;
+}
+
+void Frame::setCRCValue(quint16 newCRC)
 {
     crc = newCRC;
 }
@@ -69,7 +112,7 @@ void Frame::setFrameNumber(int number)
 
 void Frame::setValid(bool newValid)
 {
-    valid = newValid;
+    setFlag(Invalid, !newValid);
 }
 
 void Frame::setBitCount(int count)
@@ -79,18 +122,21 @@ void Frame::setBitCount(int count)
 
 void Frame::calculateCRC()
 {
-    crc = CRC::calculateCRC16(data);
+    CRC::calculateBatch(this, 1, &crc);
 }
 
 bool Frame::verifyCRC() const
 {
-    return CRC::verifyCRC16(data, crc);
+    quint16 calculated;
+    CRC::calculateBatch(this, 1, &calculated);
+    return calculated == crc;
 }
 
 QString Frame::getHexData() const
 {
+    const char *data = getConstData();
     QString result;
-    for (int i = 0; i < data.size(); ++i) {
+    for (int i = 0; i < length; ++i) {
         if (i > 0) result += " ";
         result += QString("%1").arg((unsigned char)data[i], 2, 16, QChar('0')).toUpper();
     }
@@ -99,8 +145,9 @@ QString Frame::getHexData() const
 
 QString Frame::getBinaryData() const
 {
+    const char *data = getConstData();
     QString result;
-    for (int i = 0; i < data.size(); ++i) {
+    for (int i = 0; i < length; ++i) {
         if (i > 0) result += " ";
         for (int b = 7; b >= 0; --b) {
             result += (data[i] & (1 << b)) ? "1" : "0";
@@ -117,25 +164,13 @@ QString Frame::getDetailedInfo() const
     // Basic Information
     result += QString("Frame Number: %1\n").arg(frameNumber);
     result += QString("Bit Count: %1\n").arg(bitCount);
-    result += QString("Has Padding: %1\n").arg(hasPadding ? "Yes" : "No");
-    
-    // Convert CRC to binary
-    bool ok;
-    uint16_t crcValue = crc.toUShort(&ok, 16);
-    QString binaryCRC;
-    if (ok) {
-        for (int b = 15; b >= 0; --b) {
-            binaryCRC += (crcValue & (1 << b)) ? "1" : "0";
-        }
-    } else {
-        binaryCRC = crc; // Fallback to hex if conversion fails
-    }
-    result += QString("CRC: %1\n").arg(binaryCRC);
-    
-    result += QString("Status: %1\n").arg(valid ? "Valid" : "Invalid");
+    result += QString("Has Padding: %1\n").arg(getHasPadding() ? "Yes" : "No");
+    result += QString("CRC: %1\n").arg(getBinaryCRC());
+    result += QString("Status: %1\n").arg(isValid() ? "Valid" : "Invalid");
+    result += QString("Attempts: %1\n").arg(attempts);
     
     // Frame Type Information
-    if (lastFrame) {
+    if (isLastFrame()) {
         result += "Type: Partial Frame\n";
     } else {
         result += "Type: Full Frame\n";
@@ -147,9 +182,9 @@ QString Frame::getDetailedInfo() const
     result += QString("Binary: %1\n").arg(getBinaryData());
     
     // Error Information
-    if (!errorInfo.isEmpty()) {
+    if (status & ERROR_MASK) {
         result += "\nError Information:\n";
-        for (const auto &error : errorInfo.toStdMap()) {
+        for (const auto &error : getErrorInfo().toStdMap()) {
             result += QString("%1: %2\n").arg(error.first).arg(error.second);
         }
     }
@@ -157,42 +192,86 @@ QString Frame::getDetailedInfo() const
     return result;
 }
 
-void Frame::addErrorInfo(const QString &errorType, const QString &description)
+void Frame::addError(StatusFlag error)
 {
-    errorInfo[errorType] = description;
+    setFlag(error, true);
+}
+
+bool Frame::hasError(StatusFlag error) const
+{
+    return (status & error) != 0;
 }
 
 QMap<QString, QString> Frame::getErrorInfo() const
 {
+    QMap<QString, QString> errorInfo;
+    const QString attempt = QString("(Attempt %1)").arg(attempts);
+    if (status & Lost) {
+        errorInfo["Lost"] = QString("Frame lost during transmission %1").arg(attempt);
+    }
+    if (status & Corrupted) {
+        errorInfo["Corrupted"] = QString("Frame corrupted during transmission %1").arg(attempt);
+    }
+    if (status & AckLost) {
+        errorInfo["ACK Lost"] = QString("ACK lost during transmission %1").arg(attempt);
+    }
+    if (status & TransmissionFailed) {
+        errorInfo["Transmission Failed"] = QString("Maximum retry attempts (%1) reached").arg(MAX_ATTEMPTS);
+    }
+    if (status & CRCMismatch) {
+        errorInfo["CRC Mismatch"] = "Received payload does not match its CRC";
+    }
     return errorInfo;
 }
 
+quint8 Frame::getStatus() const
+{
+    return status;
+}
+
+void Frame::setStatus(quint8 newStatus)
+{
+    status = newStatus;
+}
+
+int Frame::getAttempts() const
+{
+    return attempts;
+}
+
+void Frame::setAttempts(int count)
+{
+    attempts = static_cast<quint8>(qBound(0, count, 255));
+}
+
+void Frame::setFlag(StatusFlag flag, bool on)
+{
+    status = on ? static_cast<quint8>(status | flag) : static_cast<quint8>(status & ~flag);
+}
+
+QString Frame::getBinaryCRC() const
+{
+    QString binaryCRC;
+    for (int b = 15; b >= 0; --b) {
+        binaryCRC += (crc & (1 << b)) ? "1" : "0";
+    }
+    return binaryCRC;
+}
+
 QString Frame::toString() const
 {
     QString result = QString("Frame %1: ").arg(frameNumber);
     result += QString("Data: %1 bits, ").arg(bitCount);
-    if (hasPadding) {
+    if (getHasPadding()) {
         result += "Has Padding, ";
     }
+    result += QString("CRC: %1, ").arg(getBinaryCRC());
     
-    // Convert CRC to binary
-    bool ok;
-    uint16_t crcValue = crc.toUShort(&ok, 16);
-    QString binaryCRC;
-    if (ok) {
-        for (int b = 15; b >= 0; --b) {
-            binaryCRC += (crcValue & (1 << b)) ? "1" : "0";
-        }
-    } else {
-        binaryCRC = crc; // Fallback to hex if conversion fails
-    }
-    result += QString("CRC: %1, ").arg(binaryCRC);
-    
-    result += QString("Valid: %1").arg(valid ? "Yes" : "No");
-    if (!errorInfo.isEmpty()) {
-        result += QString(", Errors: %1").arg(errorInfo.size());
+    result += QString("Valid: %1").arg(isValid() ? "Yes" : "No");
+    if (status & ERROR_MASK) {
+        result += QString(", Errors: %1").arg(qPopulationCount(static_cast<quint8>(status & ERROR_MASK)));
     }
-    if (lastFrame) {
+    if (isLastFrame()) {
         result += ", Partial Frame";
     }
     return result;
@@ -200,20 +279,20 @@ QString Frame::toString() const
 
 bool Frame::isLastFrame() const
 {
-    return lastFrame;
+    return (status & LastFrame) != 0;
 }
 
 void Frame::setLastFrame(bool isLast)
 {
-    lastFrame = isLast;
+    setFlag(LastFrame, isLast);
 }
 
 bool Frame::getHasPadding() const
 {
-    return hasPadding;
+    return (status & Padded) != 0;
 }
 
 void Frame::setHasPadding(bool value)
 {
-    hasPadding = value;
+    setFlag(Padded, value);
 } 
\ No newline at end of file
@@ -5,36 +5,64 @@
 #include <QString>
 #include <QMap>
 
+// A frame's payload is a view (offset, length) into a shared, implicitly
+// shared buffer, so copying a frame never copies or allocates payload bytes.
 class Frame
 {
 public:
+    // Per-frame status bits, stored as one byte here and in FrameStore
+    enum StatusFlag : quint8 {
+        Invalid = 0x01,
+        LastFrame = 0x02,
+        Padded = 0x04,
+        Lost = 0x08,
+        Corrupted = 0x10,
+        AckLost = 0x20,
+        TransmissionFailed = 0x40,
+        CRCMismatch = 0x80
+    };
+
+    static const quint8 ERROR_MASK = Lost | Corrupted | AckLost | TransmissionFailed | CRCMismatch;
+    static const int MAX_ATTEMPTS = 3;
+
     Frame();
     Frame(const QByteArray &data);
+    Frame(const QByteArray &buffer, qsizetype offset, int length);
     ~Frame();
 
     // Getters
     QByteArray getData() const;
+    const char *getConstData() const;
+    int getDataSize() const;
     QString getCRC() const;
+    quint16 getCRCValue() const;
     int getFrameNumber() const;
     bool isValid() const;
     int getBitCount() const;
     bool isLastFrame() const;
     bool getHasPadding() const;
+    quint8 getStatus() const;
+    int getAttempts() const;
+    bool hasError(StatusFlag error) const;
+    // Error descriptions are only formatted here, from the status bits
     QMap<QString, QString> getErrorInfo() const;
 
     // Setters
     void setData(const QByteArray &newData);
     void setCRC(const QString &newCRC);
+    void setCRCValue(quint16 newCRC);
     void setFrameNumber(int number);
     void setValid(bool newValid);
     void setBitCount(int count);
     void setLastFrame(bool isLast);
     void setHasPadding(bool value);
+    void setStatus(quint8 newStatus);
+    void setAttempts(int count);
 
     // Operations
     void calculateCRC();
     bool verifyCRC() const;
-    void addErrorInfo(const QString &errorType, const QString &description);
+    void addError(StatusFlag error);
 
     // Display
     QString getHexData() const;
@@ -43,14 +71,17 @@ public:
     QString toString() const;
 
 private:
-    QByteArray data;
-    QString crc;
+    void setFlag(StatusFlag flag, bool on);
+    QString getBinaryCRC() const;
+
+    QByteArray buffer;
+    qsizetype offset;
+    int length;
     int frameNumber;
-    bool valid;
     int bitCount;
-    bool lastFrame;
-    bool hasPadding;
-    QMap<QString, QString> errorInfo;
+    quint16 crc;
+    quint8 status;
+    quint8 attempts;
 };
 
 #endif // FRAME_H 
\ No newline at end of file
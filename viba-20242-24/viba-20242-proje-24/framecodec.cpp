@@ -0,0 +1,34 @@
+#include "framecodec.h"
+
+namespace {
+
+const FrameGeometry GEOMETRIES[] = {
+    FrameCodec<64>::geometry(),
+    FrameCodec<100>::geometry(),
+    FrameCodec<128>::geometry(),
+    FrameCodec<512>::geometry(),
+    FrameCodec<1500 * 8>::geometry(),
+};
+
+} // namespace
+
+const FrameGeometry *FrameCodecRegistry::find(int bits, quint16 polynomial)
+{
+    for (const FrameGeometry &geometry : GEOMETRIES) {
+        if (geometry.bits == bits && geometry.polynomial == polynomial) {
+            return &geometry;
+        }
+    }
+    return nullptr;
+}
+
+QVector<int> FrameCodecRegistry::frameSizes(quint16 polynomial)
+{
+    QVector<int> sizes;
+    for (const FrameGeometry &geometry : GEOMETRIES) {
+        if (geometry.polynomial == polynomial) {
+            sizes.append(geometry.bits);
+        }
+    }
+    return sizes;
+}
@@ -0,0 +1,199 @@
+#ifndef FRAMECODEC_H
+#define FRAMECODEC_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <cstring>
+#include <numeric>
+#include <utility>
+#include "bitpacker.h"
+#include "crc.h"
+
+// One FrameCodec instantiation behind plain function pointers, for callers
+// that only learn the frame size at run time
+struct FrameGeometry {
+    int bits;
+    int bytes;
+    quint16 polynomial;
+    // See FrameCodec::cut() and FrameCodec::crc()
+    int (*cut)(const uchar *source, qint64 sourceSize, qint64 first, qint64 count,
+               uchar *payloads, quint16 *crcs);
+    quint16 (*crc)(const uchar *payload);
+};
+
+// Cuts an input into frames of Bits bits (MSB first, back to back) and
+// computes their CRC-16 over Poly, with the geometry fixed at compile time.
+// Frames start on a byte boundary again every GROUP_FRAMES frames, so a
+// group is cut with one constant shift per frame; those shifts, the tail
+// mask and the CRC tables are all constants, and every instantiation gets
+// its own unrolled, branch-free loops. Only frames at the very end of the
+// input take the generic bit-extraction path.
+template <int Bits, quint16 Poly = CRC::POLYNOMIAL>
+class FrameCodec
+{
+public:
+    static_assert(Bits > 0, "frames need at least one bit");
+
+    static constexpr int BIT_SIZE = Bits;
+    static constexpr int BYTE_SIZE = (Bits + 7) / 8;
+    static constexpr quint16 POLYNOMIAL = Poly;
+    static constexpr int GROUP_FRAMES = 8 / std::gcd(Bits, 8);
+    static constexpr int GROUP_BYTES = GROUP_FRAMES * Bits / 8;
+
+    // Writes frame index into out (BYTE_SIZE bytes, zero padded) and returns
+    // how many of its bits came from the source
+    static int extract(const uchar *source, qint64 sourceSize, qint64 index, uchar *out)
+    {
+        const qint64 frameOffset = index * Bits;
+        const int sourceBits = static_cast<int>(qMin<qint64>(Bits, sourceSize * 8 - frameOffset));
+
+        // Bits past the end of the file stay 0
+        BitPacker::extractBits(source, sourceSize, frameOffset, sourceBits, out);
+        if (sourceBits < Bits) {
+            std::memset(out + (sourceBits + 7) / 8, 0, BYTE_SIZE - (sourceBits + 7) / 8);
+        }
+        return sourceBits;
+    }
+
+    static quint16 crc(const uchar *payload)
+    {
+        quint16 value = CRC::INITIAL_VALUE;
+        int pos = 0;
+        for (; pos + 8 <= BYTE_SIZE; pos += 8) {
+            value = sliceBy8(value, payload + pos);
+        }
+        for (; pos < BYTE_SIZE; ++pos) {
+            value = static_cast<quint16>((value << 8) ^ TABLES[0][(value >> 8) ^ payload[pos]]);
+        }
+        return static_cast<quint16>(value ^ CRC::FINAL_XOR_VALUE);
+    }
+
+    // Cuts frames [first, first + count) of source into count consecutive
+    // BYTE_SIZE payloads and writes their CRCs to crcs. Returns the source bits
+    // of the last frame cut, which is less than Bits only for a partial frame.
+    static int cut(const uchar *source, qint64 sourceSize, qint64 first, qint64 count,
+                   uchar *payloads, quint16 *crcs)
+    {
+        int lastBits = Bits;
+        for (qint64 done = 0; done < count; ) {
+            // Blocks small enough that the CRC pass finds its frames in cache
+            const qint64 blockCount = qMin<qint64>(BLOCK_FRAMES, count - done);
+            uchar *blockPayloads = payloads + done * BYTE_SIZE;
+            lastBits = cutFrames(source, sourceSize, first + done, blockCount, blockPayloads);
+            crcFrames(blockPayloads, blockCount, crcs + done);
+            done += blockCount;
+        }
+        return lastBits;
+    }
+
+    static FrameGeometry geometry()
+    {
+        return FrameGeometry{ Bits, BYTE_SIZE, Poly, &cut, &crc };
+    }
+
+private:
+    static constexpr CRC::Tables TABLES = CRC::makeTables(Poly);
+    // Keeps only the frame's own bits in its last byte
+    static constexpr uchar TAIL_MASK = static_cast<uchar>(0xFF << (BYTE_SIZE * 8 - Bits));
+    static constexpr int LANES = 8;
+    static constexpr qint64 BLOCK_FRAMES = qMax(LANES * GROUP_FRAMES, 32768 / BYTE_SIZE / 8 * 8);
+
+    static quint16 sliceBy8(quint16 value, const uchar *data)
+    {
+        const quint16 head = static_cast<quint16>(value ^ ((data[0] << 8) | data[1]));
+        return static_cast<quint16>(TABLES[7][head >> 8] ^ TABLES[6][head & 0xFF]
+                                    ^ TABLES[5][data[2]] ^ TABLES[4][data[3]]
+                                    ^ TABLES[3][data[4]] ^ TABLES[2][data[5]]
+                                    ^ TABLES[1][data[6]] ^ TABLES[0][data[7]]);
+    }
+
+    // Frame K of a group starts Shift bits into byte Offset of the group.
+    // A shifted frame reads one byte past its last one, which cutFrames
+    // guarantees is still inside the source.
+    template <int K>
+    static void cutGroupFrame(const uchar *group, uchar *out)
+    {
+        constexpr int Offset = K * Bits / 8;
+        constexpr int Shift = K * Bits % 8;
+        const uchar *in = group + Offset;
+        if constexpr (Shift == 0) {
+            std::memcpy(out, in, BYTE_SIZE);
+        } else {
+            for (int i = 0; i < BYTE_SIZE; ++i) {
+                out[i] = static_cast<uchar>((in[i] << Shift) | (in[i + 1] >> (8 - Shift)));
+            }
+        }
+        out[BYTE_SIZE - 1] &= TAIL_MASK;
+    }
+
+    template <int... K>
+    static void cutGroup(const uchar *group, uchar *out, std::integer_sequence<int, K...>)
+    {
+        (cutGroupFrame<K>(group, out + K * BYTE_SIZE), ...);
+    }
+
+    static int cutFrames(const uchar *source, qint64 sourceSize, qint64 first, qint64 count, uchar *payloads)
+    {
+        const qint64 end = first + count;
+        qint64 index = first;
+        // Whole groups that also leave a byte to spare behind them
+        const qint64 fastEnd = qMin(end, sourceSize > 0 ? (sourceSize - 1) / GROUP_BYTES * GROUP_FRAMES : 0);
+
+        for (; index < fastEnd && index % GROUP_FRAMES != 0; ++index) {
+            extract(source, sourceSize, index, payloads + (index - first) * BYTE_SIZE);
+        }
+        for (; index + GROUP_FRAMES <= fastEnd; index += GROUP_FRAMES) {
+            cutGroup(source + index / GROUP_FRAMES * GROUP_BYTES, payloads + (index - first) * BYTE_SIZE,
+                     std::make_integer_sequence<int, GROUP_FRAMES>());
+        }
+
+        int lastBits = Bits;
+        for (; index < end; ++index) {
+            lastBits = extract(source, sourceSize, index, payloads + (index - first) * BYTE_SIZE);
+        }
+        return lastBits;
+    }
+
+    // LANES independent CRC chains at a time, as in CRC::calculateBatch
+    static void crcFrames(const uchar *payloads, qint64 count, quint16 *out)
+    {
+        qint64 i = 0;
+        for (; i + LANES <= count; i += LANES) {
+            const uchar *lanes = payloads + i * BYTE_SIZE;
+            quint16 value[LANES];
+            for (int l = 0; l < LANES; ++l) {
+                value[l] = CRC::INITIAL_VALUE;
+            }
+            int pos = 0;
+            for (; pos + 8 <= BYTE_SIZE; pos += 8) {
+                for (int l = 0; l < LANES; ++l) {
+                    value[l] = sliceBy8(value[l], lanes + l * BYTE_SIZE + pos);
+                }
+            }
+            for (; pos < BYTE_SIZE; ++pos) {
+                for (int l = 0; l < LANES; ++l) {
+                    value[l] = static_cast<quint16>((value[l] << 8)
+                        ^ TABLES[0][(value[l] >> 8) ^ lanes[l * BYTE_SIZE + pos]]);
+                }
+            }
+            for (int l = 0; l < LANES; ++l) {
+                out[i + l] = static_cast<quint16>(value[l] ^ CRC::FINAL_XOR_VALUE);
+            }
+        }
+        for (; i < count; ++i) {
+            out[i] = crc(payloads + i * BYTE_SIZE);
+        }
+    }
+};
+
+// The FrameCodec instantiations built into the program: 64, 100, 128, 512
+// and 12000 (1500 bytes) bit frames, all with the CRC polynomial
+class FrameCodecRegistry
+{
+public:
+    // Null if no instantiation matches
+    static const FrameGeometry *find(int bits, quint16 polynomial = CRC::POLYNOMIAL);
+    static QVector<int> frameSizes(quint16 polynomial = CRC::POLYNOMIAL);
+};
+
+#endif // FRAMECODEC_H
@@ -0,0 +1,53 @@
+#include "framelistmodel.h"
+#include <QBrush>
+
+FrameListModel::FrameListModel(DataLinkLayer *layer, QObject *parent)
+    : QAbstractListModel(parent)
+    , layer(layer)
+    , frames(0)
+{
+}
+
+int FrameListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : frames;
+}
+
+QVariant FrameListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= frames) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return layer->frameAt(index.row()).toString();
+    case Qt::ForegroundRole:
+        return QBrush(layer->frameAt(index.row()).isValid() ? Qt::black : Qt::red);
+    default:
+        return QVariant();
+    }
+}
+
+void FrameListModel::reload()
+{
+    beginResetModel();
+    frames = layer->frameCount();
+    endResetModel();
+}
+
+void FrameListModel::frameChanged(int frameIndex)
+{
+    if (frameIndex < 0 || frameIndex >= frames) {
+        return;
+    }
+    const QModelIndex row = index(frameIndex);
+    emit dataChanged(row, row, {Qt::DisplayRole, Qt::ForegroundRole});
+}
+
+void FrameListModel::refresh()
+{
+    if (frames > 0) {
+        emit dataChanged(index(0), index(frames - 1), {Qt::DisplayRole, Qt::ForegroundRole});
+    }
+}
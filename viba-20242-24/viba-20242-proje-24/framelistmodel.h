@@ -0,0 +1,32 @@
+#ifndef FRAMELISTMODEL_H
+#define FRAMELISTMODEL_H
+
+#include <QAbstractListModel>
+#include "datalinklayer.h"
+
+// One row per loaded frame, row == frame index. Rows are formatted from the
+// DataLinkLayer's store when the view asks for them, so nothing is held per
+// frame here and a status change is a single dataChanged.
+class FrameListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit FrameListModel(DataLinkLayer *layer, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Picks up a newly loaded file
+    void reload();
+    // One frame's status changed
+    void frameChanged(int frameIndex);
+    // Every frame's status may have changed, e.g. at the end of a run
+    void refresh();
+
+private:
+    DataLinkLayer *layer;
+    int frames;
+};
+
+#endif // FRAMELISTMODEL_H
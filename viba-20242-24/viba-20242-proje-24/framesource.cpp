@@ -0,0 +1,87 @@
+#include "framesource.h"
+#include "framecodec.h"
+
+FrameSource::FrameSource()
+    : mapped(nullptr)
+    , size(0)
+{
+}
+
+FrameSource::~FrameSource()
+{
+    close();
+}
+
+bool FrameSource::open(const QString &filePath)
+{
+    close();
+
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    size = file.size();
+    if (size > 0) {
+        mapped = file.map(0, size);
+        if (!mapped) {
+            file.close();
+            size = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrameSource::close()
+{
+    if (mapped) {
+        file.unmap(const_cast<uchar *>(mapped));
+        mapped = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+    size = 0;
+}
+
+qint64 FrameSource::frameCount() const
+{
+    return frameCountFor(size);
+}
+
+qint64 FrameSource::fileSize() const
+{
+    return size;
+}
+
+Frame FrameSource::frameAt(qint64 index) const
+{
+    QByteArray payload(FRAME_BYTE_SIZE, 0);
+    const int sourceBits = extractFrame(mapped, size, index, reinterpret_cast<uchar *>(payload.data()));
+    Frame frame = makeFrame(payload, 0, index, sourceBits);
+    frame.setCRCValue(FrameCodec<FRAME_BIT_SIZE>::crc(reinterpret_cast<const uchar *>(payload.constData())));
+    return frame;
+}
+
+int FrameSource::extractFrame(const uchar *source, qint64 sourceSize, qint64 index, uchar *out)
+{
+    return FrameCodec<FRAME_BIT_SIZE>::extract(source, sourceSize, index, out);
+}
+
+Frame FrameSource::makeFrame(const QByteArray &payload, qsizetype offset, qint64 index, int sourceBits)
+{
+    Frame frame(payload, offset, FRAME_BYTE_SIZE);
+    frame.setFrameNumber(static_cast<int>(index));
+    frame.setBitCount(FRAME_BIT_SIZE); // Partial frames are padded to 100 bits
+    if (sourceBits < FRAME_BIT_SIZE) {
+        frame.setLastFrame(true);
+        frame.setHasPadding(true);
+    }
+    return frame;
+}
+
+qint64 FrameSource::frameCountFor(qint64 sourceSize)
+{
+    return (sourceSize * 8 + FRAME_BIT_SIZE - 1) / FRAME_BIT_SIZE;
+}
@@ -0,0 +1,41 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <QFile>
+#include <QString>
+#include "frame.h"
+
+// Memory-mapped input file that hands out frames on demand. Frame i covers
+// bits [100 * i, 100 * i + 100) of the file, so nothing is materialized up front.
+class FrameSource
+{
+public:
+    static const int FRAME_BIT_SIZE = 100;
+    static const int FRAME_BYTE_SIZE = (FRAME_BIT_SIZE + 7) / 8;
+
+    FrameSource();
+    ~FrameSource();
+
+    bool open(const QString &filePath);
+    void close();
+
+    qint64 frameCount() const;
+    qint64 fileSize() const;
+    Frame frameAt(qint64 index) const;
+
+    // Writes frame index into out (FRAME_BYTE_SIZE bytes, zero padded) and
+    // returns how many of its bits came from the source
+    static int extractFrame(const uchar *source, qint64 sourceSize, qint64 index, uchar *out);
+    // Frame viewing the FRAME_BYTE_SIZE bytes at offset in payload; no CRC yet
+    static Frame makeFrame(const QByteArray &payload, qsizetype offset, qint64 index, int sourceBits);
+    static qint64 frameCountFor(qint64 sourceSize);
+
+private:
+    QFile file;
+    const uchar *mapped;
+    qint64 size;
+
+    Q_DISABLE_COPY(FrameSource)
+};
+
+#endif // FRAMESOURCE_H
@@ -0,0 +1,217 @@
+#include "framestore.h"
+#include <QtConcurrent>
+#include "framecodec.h"
+
+namespace {
+
+// Frames [first, first + count) of the input and the source bits of the last one
+struct LoadChunk {
+    qint64 first;
+    qint64 count;
+    int lastBits;
+};
+
+} // namespace
+
+FrameStore::FrameStore()
+    : frameCount(0)
+    , bitsPerFrame(FrameSource::FRAME_BIT_SIZE)
+    , bytesPerFrame(FrameSource::FRAME_BYTE_SIZE)
+{
+}
+
+void FrameStore::clear()
+{
+    payload.clear();
+    crcs.clear();
+    statuses.clear();
+    attemptCounts.clear();
+    frameCount = 0;
+    bitsPerFrame = FrameSource::FRAME_BIT_SIZE;
+    bytesPerFrame = FrameSource::FRAME_BYTE_SIZE;
+    source.reset();
+}
+
+bool FrameStore::load(const QByteArray &fileData, int frameBits)
+{
+    return load(reinterpret_cast<const uchar *>(fileData.constData()), fileData.size(), frameBits);
+}
+
+bool FrameStore::load(const uchar *data, qint64 size, int frameBits)
+{
+    clear();
+    const FrameGeometry *geometry = FrameCodecRegistry::find(frameBits);
+    if (!geometry) {
+        return false;
+    }
+
+    bitsPerFrame = geometry->bits;
+    bytesPerFrame = geometry->bytes;
+    frameCount = static_cast<int>((size * 8 + bitsPerFrame - 1) / bitsPerFrame);
+
+    // Every byte is written by the cut, so the buffer is left uninitialized
+    // and its pages are first touched by the threads that fill them
+    payload = QByteArray(static_cast<qsizetype>(frameCount) * bytesPerFrame, Qt::Uninitialized);
+    crcs.resize(frameCount);
+    uchar *payloads = reinterpret_cast<uchar *>(payload.data());
+    quint16 *crcValues = crcs.data();
+
+    // A frame depends only on its own bits, so chunks are cut and CRC'd
+    // independently, each straight into its own slice of the arrays
+    QVector<LoadChunk> chunks;
+    chunks.reserve(frameCount / LOAD_CHUNK_FRAMES + 1);
+    for (qint64 first = 0; first < frameCount; first += LOAD_CHUNK_FRAMES) {
+        chunks.append(LoadChunk{ first, qMin<qint64>(LOAD_CHUNK_FRAMES, frameCount - first), 0 });
+    }
+    const int frameBytes = bytesPerFrame;
+    auto cutChunk = [=](LoadChunk &chunk) {
+        chunk.lastBits = geometry->cut(data, size, chunk.first, chunk.count,
+                                       payloads + chunk.first * frameBytes, crcValues + chunk.first);
+    };
+    if (frameCount >= PARALLEL_LOAD_MIN_FRAMES) {
+        QtConcurrent::blockingMap(chunks, cutChunk);
+    } else {
+        for (LoadChunk &chunk : chunks) {
+            cutChunk(chunk);
+        }
+    }
+
+    statuses.fill(0, frameCount);
+    attemptCounts.fill(0, frameCount);
+    if (!chunks.isEmpty() && chunks.last().lastBits < bitsPerFrame) {
+        statuses[frameCount - 1] = Frame::LastFrame | Frame::Padded;
+    }
+    return true;
+}
+
+void FrameStore::attach(const QSharedPointer<FrameSource> &mappedSource)
+{
+    clear();
+    source = mappedSource;
+    frameCount = source ? static_cast<int>(source->frameCount()) : 0;
+}
+
+int FrameStore::count() const
+{
+    return frameCount;
+}
+
+bool FrameStore::isEmpty() const
+{
+    return frameCount == 0;
+}
+
+bool FrameStore::isMapped() const
+{
+    return !source.isNull();
+}
+
+bool FrameStore::hasPartialFrame() const
+{
+    return frameCount > 0 && (status(frameCount - 1) & Frame::Padded);
+}
+
+int FrameStore::frameBitSize() const
+{
+    return bitsPerFrame;
+}
+
+int FrameStore::frameByteSize() const
+{
+    return bytesPerFrame;
+}
+
+Frame FrameStore::frame(int index) const
+{
+    if (index < 0 || index >= frameCount) {
+        return Frame();
+    }
+    if (source) {
+        return source->frameAt(index);
+    }
+
+    Frame result(payload, static_cast<qsizetype>(index) * bytesPerFrame, bytesPerFrame);
+    result.setFrameNumber(index);
+    result.setBitCount(bitsPerFrame); // Partial frames are padded to the full size
+    result.setCRCValue(crcs.at(index));
+    result.setStatus(statuses.at(index));
+    result.setAttempts(attemptCounts.at(index));
+    return result;
+}
+
+QVector<Frame> FrameStore::toFrames() const
+{
+    QVector<Frame> result;
+    if (source) {
+        return result;
+    }
+    result.reserve(frameCount);
+    for (int i = 0; i < frameCount; ++i) {
+        result.append(frame(i));
+    }
+    return result;
+}
+
+quint16 FrameStore::crc(int index) const
+{
+    if (source) {
+        return source->frameAt(index).getCRCValue();
+    }
+    return crcs.at(index);
+}
+
+quint8 FrameStore::status(int index) const
+{
+    if (source) {
+        return source->frameAt(index).getStatus();
+    }
+    return statuses.at(index);
+}
+
+int FrameStore::attempts(int index) const
+{
+    return source ? 0 : attemptCounts.at(index);
+}
+
+void FrameStore::record(const Frame &frame)
+{
+    record(frame.getFrameNumber(), frame.getStatus(), frame.getAttempts());
+}
+
+void FrameStore::record(int index, quint8 status, int attempts)
+{
+    if (source || index < 0 || index >= frameCount) {
+        return;
+    }
+    statuses[index] = status;
+    attemptCounts[index] = static_cast<quint8>(attempts);
+}
+
+void FrameStore::resetStatuses()
+{
+    // Keeps the flags load() sets on a padded last frame
+    for (quint8 &status : statuses) {
+        status &= Frame::LastFrame | Frame::Padded;
+    }
+    attemptCounts.fill(0);
+}
+
+int FrameStore::countWithStatus(quint8 mask) const
+{
+    int result = 0;
+    for (quint8 value : statuses) {
+        result += (value & mask) ? 1 : 0;
+    }
+    return result;
+}
+
+QVector<int> FrameStore::indicesWithStatus(quint8 mask) const
+{
+    QVector<int> result;
+    for (int i = 0; i < statuses.size(); ++i) {
+        if (statuses.at(i) & mask) {
+            result.append(i);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,72 @@
+#ifndef FRAMESTORE_H
+#define FRAMESTORE_H
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QVector>
+#include "frame.h"
+#include "framesource.h"
+
+// Structure-of-arrays storage for all frames of a loaded file. Payloads sit
+// back to back in one buffer and per-frame metadata is kept in dense arrays
+// (CRC, status bits, attempt count: four bytes per frame), so statistics
+// and filters are linear scans. Frame objects are views built on request.
+//
+// A store can instead wrap a memory-mapped FrameSource; it then keeps no
+// per-frame arrays and frames are cut from the mapping when asked for.
+// Copies share all arrays implicitly.
+//
+// Loaded stores may use any frame size FrameCodecRegistry knows; mapped
+// stores always use FrameSource::FRAME_BIT_SIZE.
+class FrameStore
+{
+public:
+    FrameStore();
+
+    void clear();
+    // False, with the store left empty, if frameBits has no FrameCodec.
+    // Large inputs are cut in parallel chunks on the global thread pool.
+    bool load(const QByteArray &fileData, int frameBits = FrameSource::FRAME_BIT_SIZE);
+    bool load(const uchar *data, qint64 size, int frameBits = FrameSource::FRAME_BIT_SIZE);
+    void attach(const QSharedPointer<FrameSource> &mappedSource);
+
+    int count() const;
+    bool isEmpty() const;
+    bool isMapped() const;
+    bool hasPartialFrame() const;
+    int frameBitSize() const;
+    int frameByteSize() const;
+
+    Frame frame(int index) const;
+    QVector<Frame> toFrames() const;
+
+    quint16 crc(int index) const;
+    quint8 status(int index) const;
+    int attempts(int index) const;
+
+    // Stores the status and attempt count a processed frame came back with
+    void record(const Frame &frame);
+    void record(int index, quint8 status, int attempts);
+    // Forgets every recorded status and attempt count, as before a new run
+    void resetStatuses();
+    int countWithStatus(quint8 mask) const;
+    QVector<int> indicesWithStatus(quint8 mask) const;
+
+private:
+    // Frames cut per task, a multiple of every codec's group of frames so
+    // each chunk starts on a byte boundary
+    static const int LOAD_CHUNK_FRAMES = 64 * 1024;
+    // Smaller inputs are cut on the calling thread
+    static const int PARALLEL_LOAD_MIN_FRAMES = 4 * LOAD_CHUNK_FRAMES;
+
+    QByteArray payload;
+    QVector<quint16> crcs;
+    QVector<quint8> statuses;
+    QVector<quint8> attemptCounts;
+    int frameCount;
+    int bitsPerFrame;
+    int bytesPerFrame;
+    QSharedPointer<FrameSource> source;
+};
+
+#endif // FRAMESTORE_H
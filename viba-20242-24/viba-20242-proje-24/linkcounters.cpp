@@ -0,0 +1,26 @@
+#include "linkcounters.h"
+
+LinkCounters::LinkCounters()
+{
+}
+
+void LinkCounters::reset()
+{
+    for (Cell &cell : cells) {
+        cell.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+LinkStats LinkCounters::snapshot() const
+{
+    LinkStats stats;
+    stats.attempts = cells[Attempts].value.load(std::memory_order_relaxed);
+    stats.successes = cells[Successes].value.load(std::memory_order_relaxed);
+    stats.losses = cells[Losses].value.load(std::memory_order_relaxed);
+    stats.corruptions = cells[Corruptions].value.load(std::memory_order_relaxed);
+    stats.ackLosses = cells[AckLosses].value.load(std::memory_order_relaxed);
+    stats.retries = cells[Retries].value.load(std::memory_order_relaxed);
+    stats.failures = cells[Failures].value.load(std::memory_order_relaxed);
+    stats.wireBytes = cells[WireBytes].value.load(std::memory_order_relaxed);
+    return stats;
+}
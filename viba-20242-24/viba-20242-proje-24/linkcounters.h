@@ -0,0 +1,60 @@
+#ifndef LINKCOUNTERS_H
+#define LINKCOUNTERS_H
+
+#include <QtGlobal>
+#include <atomic>
+
+// Transmission counters of one run at one moment
+struct LinkStats {
+    qint64 attempts = 0;    // Frames put on the wire, resends included
+    qint64 successes = 0;   // Frames delivered to the receiver
+    qint64 losses = 0;      // Transmissions lost on the channel
+    qint64 corruptions = 0; // Transmissions corrupted on the channel
+    qint64 ackLosses = 0;
+    qint64 retries = 0;     // Attempts that were resends
+    qint64 failures = 0;    // Frames given up after Frame::MAX_ATTEMPTS
+    qint64 wireBytes = 0;   // Framed bytes on the wire, resends included
+};
+
+// Live counters of one worker. The worker is the only writer; any thread
+// may take a snapshot at any time without locking or waiting. Every
+// counter sits on its own cache line so readers polling one counter do
+// not pull in the line the worker is writing next.
+class LinkCounters
+{
+public:
+    enum Counter {
+        Attempts,
+        Successes,
+        Losses,
+        Corruptions,
+        AckLosses,
+        Retries,
+        Failures,
+        WireBytes,
+        COUNTER_COUNT
+    };
+
+    LinkCounters();
+
+    // Writer side only. With a single writer a relaxed load and store is
+    // enough and avoids a locked read-modify-write per frame.
+    void add(Counter counter, qint64 amount = 1)
+    {
+        std::atomic<qint64> &value = cells[counter].value;
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    void reset();
+
+    // Each counter is exact; during a run they may be a few events apart
+    LinkStats snapshot() const;
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<qint64> value{0};
+    };
+
+    Cell cells[COUNTER_COUNT];
+};
+
+#endif // LINKCOUNTERS_H
@@ -1,11 +1,10 @@
 #include "mainwindow.h"
 #include <QMessageBox>
 #include <QProgressBar>
-#include <QGraphicsRectItem>
-#include <QGraphicsTextItem>
 #include <QDateTime>
 #include <QFileInfo>
 #include <QDebug>
+#include <QtConcurrent>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -15,37 +14,38 @@ MainWindow::MainWindow(QWidget *parent)
     , openFileButton(new QPushButton("Open File", this))
     , processButton(new QPushButton("Process Data", this))
     , simulateButton(new QPushButton("Start Transmission", this))
-    , frameList(new QListWidget(this))
+    , monteCarloButton(new QPushButton("Monte Carlo", this))
+    , arqModeCombo(new QComboBox(this))
+    , framingCombo(new QComboBox(this))
+    , windowSizeSpin(new QSpinBox(this))
+    , realTimeCheck(new QCheckBox("Real-time", this))
+    , frameList(new QListView(this))
     , checksumLabel(new QLabel("Checksum: Not calculated", this))
     , statusLabel(new QLabel("Status: Ready", this))
     , progressBar(new QProgressBar(this))
     , datalinkLayer(new DataLinkLayer(this))
+    , frameModel(new FrameListModel(datalinkLayer, this))
     , detailsTabWidget(new QTabWidget)
     , frameDetailsText(new QTextEdit)
     , statisticsText(new QTextEdit)
     , errorLogText(new QTextEdit)
     , visualizationLayout(new QHBoxLayout())
-    , scene(new QGraphicsScene(this))
-    , visualizationView(new QGraphicsView(scene))
-    , senderLabel(new QLabel("Sender", this))
-    , receiverLabel(new QLabel("Receiver", this))
-    , sendingScene(new QGraphicsScene(this))
-    , receivingScene(new QGraphicsScene(this))
+    , timeline(new TimelineWidget(datalinkLayer, this))
+    , timelineLabel(new QLabel("Timeline: green delivered, amber retried, red failed, grey pending (wheel to zoom)", this))
+    , eventTimer(new QTimer(this))
+    , droppedAtStart(0)
+    , refreshTimer(new QTimer(this))
+    , statisticsDirty(false)
+    , progressDirty(false)
+    , statusDirty(false)
 {
     setCentralWidget(centralWidget);
+    eventBatch.resize(EVENT_BATCH_SIZE);
+    eventTimer->setInterval(EVENT_DRAIN_INTERVAL_MS);
+    refreshTimer->setInterval(REFRESH_INTERVAL_MS);
+    refreshTimer->setSingleShot(true);
     setupUI();
     createConnections();
-
-    // Initialize visualization scenes
-    sendingScene->setSceneRect(0, 0, 400, 200);
-    receivingScene->setSceneRect(0, 0, 400, 200);
-    
-    // Set up visualization view
-    visualizationView->setScene(sendingScene);
-    visualizationView->setMinimumSize(400, 200);
-    visualizationView->setRenderHint(QPainter::Antialiasing);
-    visualizationView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    visualizationView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
 }
 
 MainWindow::~MainWindow()
@@ -66,6 +66,28 @@ void MainWindow::setupUI()
     buttonLayout->addWidget(openFileButton);
     buttonLayout->addWidget(processButton);
     buttonLayout->addWidget(simulateButton);
+    buttonLayout->addWidget(monteCarloButton);
+
+    // ARQ mode selection
+    arqModeCombo->addItem("Stop-and-Wait");
+    arqModeCombo->addItem("Go-Back-N");
+    arqModeCombo->addItem("Selective Repeat");
+    windowSizeSpin->setRange(1, DataLinkWorker::MAX_WINDOW_SIZE);
+    windowSizeSpin->setValue(DataLinkWorker::DEFAULT_WINDOW_SIZE);
+    windowSizeSpin->setPrefix("Window: ");
+    windowSizeSpin->setEnabled(false);
+    buttonLayout->addWidget(arqModeCombo);
+    buttonLayout->addWidget(windowSizeSpin);
+
+    // Framing on the simulated wire
+    framingCombo->addItem("Byte stuffing");
+    framingCombo->addItem("HDLC bit stuffing");
+    buttonLayout->addWidget(framingCombo);
+
+    // The simulation runs on a virtual clock; real time paces it for watching
+    realTimeCheck->setChecked(true);
+    datalinkLayer->setRealTime(true);
+    buttonLayout->addWidget(realTimeCheck);
 
     // Add widgets to main layout
     mainLayout->addLayout(buttonLayout);
@@ -74,7 +96,9 @@ void MainWindow::setupUI()
     mainLayout->addWidget(checksumLabel);
     mainLayout->addWidget(statusLabel);
 
-    // Configure frame list
+    // Configure frame list: one row per frame, laid out without measuring each
+    frameList->setModel(frameModel);
+    frameList->setUniformItemSizes(true);
     frameList->setAlternatingRowColors(true);
     frameList->setSelectionMode(QAbstractItemView::SingleSelection);
     frameList->setFont(QFont("Consolas", 10));
@@ -82,6 +106,7 @@ void MainWindow::setupUI()
     // Set initial button states
     processButton->setEnabled(false);
     simulateButton->setEnabled(false);
+    monteCarloButton->setEnabled(false);
 
     // Add details tab widget
     detailsTabWidget->addTab(frameDetailsText, "Frame Details");
@@ -93,14 +118,10 @@ void MainWindow::setupUI()
     // Create visualization layout
     visualizationLayout = new QHBoxLayout();
     
-    // Create and setup visualization components
-    visualizationView->setMinimumSize(400, 200);
-    visualizationView->setRenderHint(QPainter::Antialiasing);
-    
+    // Transmission timeline, painted from per-frame states
     QVBoxLayout *labelsLayout = new QVBoxLayout();
-    labelsLayout->addWidget(senderLabel);
-    labelsLayout->addWidget(visualizationView);
-    labelsLayout->addWidget(receiverLabel);
+    labelsLayout->addWidget(timelineLabel);
+    labelsLayout->addWidget(timeline);
     
     visualizationLayout->addLayout(labelsLayout);
     mainLayout->addLayout(visualizationLayout);
@@ -113,7 +134,15 @@ void MainWindow::createConnections()
     connect(openFileButton, &QPushButton::clicked, this, &MainWindow::openFile);
     connect(processButton, &QPushButton::clicked, this, &MainWindow::processData);
     connect(simulateButton, &QPushButton::clicked, this, &MainWindow::simulateTransmission);
-    connect(frameList, &QListWidget::itemClicked, this, &MainWindow::onFrameSelected);
+    connect(monteCarloButton, &QPushButton::clicked, this, &MainWindow::runMonteCarlo);
+    connect(&monteCarloWatcher, &QFutureWatcher<MonteCarloRunner::Summary>::finished, this, &MainWindow::onMonteCarloFinished);
+    connect(eventTimer, &QTimer::timeout, this, &MainWindow::drainEvents);
+    connect(refreshTimer, &QTimer::timeout, this, &MainWindow::refreshDisplay);
+    connect(frameList, &QListView::clicked, this, &MainWindow::onFrameSelected);
+    connect(arqModeCombo, &QComboBox::currentIndexChanged, this, &MainWindow::onArqModeChanged);
+    connect(windowSizeSpin, &QSpinBox::valueChanged, datalinkLayer, &DataLinkLayer::setWindowSize);
+    connect(framingCombo, &QComboBox::currentIndexChanged, this, &MainWindow::onFramingChanged);
+    connect(realTimeCheck, &QCheckBox::toggled, datalinkLayer, &DataLinkLayer::setRealTime);
 
     // Connect MainWindow signals
     connect(this, &MainWindow::errorOccurred, this, &MainWindow::onErrorOccurred);
@@ -121,10 +150,13 @@ void MainWindow::createConnections()
     // Connect DataLinkLayer signals
     connect(datalinkLayer, &DataLinkLayer::frameProcessed, this, &MainWindow::updateFrameStatus);
     connect(datalinkLayer, &DataLinkLayer::transmissionComplete, this, &MainWindow::onTransmissionComplete);
+    connect(datalinkLayer, &DataLinkLayer::transmissionStopped, this, &MainWindow::onTransmissionStopped);
     connect(datalinkLayer, &DataLinkLayer::errorOccurred, this, &MainWindow::onErrorOccurred);
     connect(datalinkLayer, &DataLinkLayer::statusUpdate, this, &MainWindow::onStatusUpdate);
     connect(datalinkLayer, &DataLinkLayer::checksumCalculated, this, &MainWindow::onChecksumCalculated);
     connect(datalinkLayer, &DataLinkLayer::checksumFrameSent, this, &MainWindow::onChecksumFrameSent);
+    connect(datalinkLayer, &DataLinkLayer::throughputMeasured, this, &MainWindow::onThroughputMeasured);
+    connect(datalinkLayer, &DataLinkLayer::retransmissionsCounted, this, &MainWindow::onRetransmissionsCounted);
 }
 
 void MainWindow::openFile()
@@ -133,7 +165,7 @@ void MainWindow::openFile()
     if (!filePath.isEmpty()) {
         currentFilePath = filePath;
         processButton->setEnabled(true);
-        statusLabel->setText("Status: File selected - " + QFileInfo(filePath).fileName());
+        setStatus("Status: File selected - " + QFileInfo(filePath).fileName());
     }
 }
 
@@ -149,27 +181,28 @@ void MainWindow::processData()
         return;
     }
 
-    auto frames = datalinkLayer->getFrames();
-    if (frames.isEmpty()) {
+    const int frameCount = datalinkLayer->frameCount();
+    if (frameCount == 0) {
         QMessageBox::warning(this, "Error", "No frames to process");
         return;
     }
 
-    totalFrames = frames.size();
-    processedFrames = 0;
+    totalFrames = frameCount;
     stats = Statistics(); // Reset statistics
     stats.totalFrames = totalFrames; // Set total frames for statistics
     
     qDebug() << "ProcessData - Total Frames:" << totalFrames;
     qDebug() << "ProcessData - Stats Total Frames:" << stats.totalFrames;
     
-    frameList->clear();
+    frameModel->reload();
+    timeline->reload();
     progressBar->setRange(0, 100); // Set range to percentage
     progressBar->setValue(0);
     progressBar->setVisible(true); // Show progress bar
     
     simulateButton->setEnabled(true);
-    statusLabel->setText(QString("Status: Ready to transmit - %1 frames loaded").arg(totalFrames));
+    monteCarloButton->setEnabled(true);
+    setStatus(QString("Status: Ready to transmit - %1 frames loaded").arg(totalFrames));
     
     // Update statistics immediately after setting totalFrames
     updateStatistics();
@@ -194,8 +227,7 @@ void MainWindow::simulateTransmission()
             }
 
             clearVisualization();
-            frameList->clear();
-            processedFrames = 0;
+            frameList->scrollToTop();
             progressBar->setValue(0);
             progressBar->setVisible(true); // Show progress bar
             stats = Statistics(); // Reset statistics
@@ -204,9 +236,12 @@ void MainWindow::simulateTransmission()
             qDebug() << "SimulateTransmission - Stats Total Frames:" << stats.totalFrames;
             
             try {
+                drainEvents(); // Leftovers from a stopped run
+                droppedAtStart = datalinkLayer->droppedEvents();
                 datalinkLayer->startTransmission();
+                eventTimer->start();
                 simulateButton->setText("Stop Transmission");
-                statusLabel->setText("Status: Transmission in progress...");
+                setStatus("Status: Transmission in progress...");
                 qDebug() << "Transmission started successfully";
             } catch (const std::exception& e) {
                 qDebug() << "Error starting transmission:" << e.what();
@@ -218,7 +253,7 @@ void MainWindow::simulateTransmission()
             try {
                 datalinkLayer->stopTransmission();
                 simulateButton->setText("Start Transmission");
-                statusLabel->setText("Status: Transmission stopped");
+                setStatus("Status: Transmission stopped");
                 progressBar->setVisible(false); // Hide progress bar
                 qDebug() << "Transmission stopped successfully";
             } catch (const std::exception& e) {
@@ -232,18 +267,16 @@ void MainWindow::simulateTransmission()
     }
 }
 
-void MainWindow::onFrameSelected(QListWidgetItem *item)
+void MainWindow::onFrameSelected(const QModelIndex &index)
 {
     try {
-        // Parse frame number from the item text
-        QStringList parts = item->text().split(" ");
-        int frameNumber = parts[1].replace(":", "").toInt();
-        
+        // Rows are frame indices
+        const int frameNumber = index.row();
+
         qDebug() << "Selected frame number:" << frameNumber;
         
-        auto frames = datalinkLayer->getFrames();
-        if (frameNumber >= 0 && frameNumber < frames.size()) {
-            showFrameDetails(frames[frameNumber]);
+        if (frameNumber >= 0 && frameNumber < datalinkLayer->frameCount()) {
+            showFrameDetails(datalinkLayer->frameAt(frameNumber));
         } else {
             qDebug() << "Invalid frame number:" << frameNumber;
             emit errorOccurred(QString("Invalid frame number: %1").arg(frameNumber));
@@ -254,33 +287,68 @@ void MainWindow::onFrameSelected(QListWidgetItem *item)
     }
 }
 
+void MainWindow::onArqModeChanged(int index)
+{
+    ArqMode mode = ArqMode::StopAndWait;
+    if (index == 1) {
+        mode = ArqMode::GoBackN;
+    } else if (index == 2) {
+        mode = ArqMode::SelectiveRepeat;
+    }
+    datalinkLayer->setArqMode(mode);
+    windowSizeSpin->setEnabled(mode != ArqMode::StopAndWait);
+}
+
+void MainWindow::onFramingChanged(int index)
+{
+    datalinkLayer->setFramingMode(index == 1 ? FramingMode::BitStuffing : FramingMode::ByteStuffing);
+}
+
+void MainWindow::onThroughputMeasured(double effectiveBitsPerSecond, double stopAndWaitBitsPerSecond)
+{
+    stats.throughput = effectiveBitsPerSecond;
+    stats.stopAndWaitThroughput = stopAndWaitBitsPerSecond;
+    statisticsDirty = true;
+    scheduleRefresh();
+}
+
+void MainWindow::onRetransmissionsCounted(int transmissions, int retransmissions)
+{
+    stats.link.attempts = transmissions;
+    stats.link.retries = retransmissions;
+    statisticsDirty = true;
+    scheduleRefresh();
+}
+
+void MainWindow::runMonteCarlo()
+{
+    if (monteCarloWatcher.isRunning()) {
+        return;
+    }
+
+    // Trials run on the global thread pool; the window stays responsive
+    const MonteCarloRunner runner = datalinkLayer->monteCarloRunner();
+    monteCarloButton->setEnabled(false);
+    setStatus(QString("Status: Running %1 Monte Carlo trials...").arg(MONTE_CARLO_TRIALS));
+    monteCarloWatcher.setFuture(QtConcurrent::run([runner]() {
+        return runner.run(MONTE_CARLO_TRIALS, MONTE_CARLO_SEED);
+    }));
+}
+
+void MainWindow::onMonteCarloFinished()
+{
+    const MonteCarloRunner::Summary summary = monteCarloWatcher.result();
+    statisticsDirty = false; // Keep the summary on screen
+    statisticsText->setText(MonteCarloRunner::formatSummary(summary));
+    detailsTabWidget->setCurrentWidget(statisticsText);
+    setStatus(QString("Status: Monte Carlo complete - %1 trials").arg(summary.trials));
+    monteCarloButton->setEnabled(true);
+}
+
 void MainWindow::showFrameDetails(const Frame &frame)
 {
     try {
-        QString details;
-        details += QString("=== Frame %1 Details ===\n\n").arg(frame.getFrameNumber());
-        
-        // Basic Information
-        details += QString("Frame Number: %1\n").arg(frame.getFrameNumber());
-        details += QString("Bit Count: %1\n").arg(frame.getBitCount());
-        details += QString("CRC: %1\n").arg(frame.getCRC());
-        details += QString("Status: %1\n").arg(frame.isValid() ? "Valid" : "Invalid");
-        details += QString("Type: %1\n").arg(frame.isLastFrame() ? "Partial Frame" : "Full Frame");
-        
-        // Data Information
-        details += "\nData:\n";
-        details += QString("Hex: %1\n").arg(frame.getHexData());
-        details += QString("Binary: %1\n").arg(frame.getBinaryData());
-        
-        // Error Information
-        if (!frame.getErrorInfo().isEmpty()) {
-            details += "\nError Information:\n";
-            for (const auto &error : frame.getErrorInfo().toStdMap()) {
-                details += QString("%1: %2\n").arg(error.first).arg(error.second);
-            }
-        }
-        
-        frameDetailsText->setText(details);
+        frameDetailsText->setText(frame.getDetailedInfo());
         qDebug() << "Displayed details for frame" << frame.getFrameNumber();
     } catch (const std::exception& e) {
         qDebug() << "Error showing frame details:" << e.what();
@@ -295,32 +363,47 @@ void MainWindow::updateStatistics()
         statsText += "=== Transmission Statistics ===\n\n";
         
         // Ensure totalFrames is not zero to avoid division by zero
+        const LinkStats &link = stats.link;
         if (stats.totalFrames > 0) {
             statsText += QString("Total Frames: %1\n").arg(stats.totalFrames);
-            statsText += QString("Successful Frames: %1 (%2%)\n")
-                .arg(stats.successfulFrames)
-                .arg((stats.successfulFrames * 100.0) / stats.totalFrames, 0, 'f', 2);
-            statsText += QString("Lost Frames: %1 (%2%)\n")
-                .arg(stats.lostFrames)
-                .arg((stats.lostFrames * 100.0) / stats.totalFrames, 0, 'f', 2);
-            statsText += QString("Corrupted Frames: %1 (%2%)\n")
-                .arg(stats.corruptedFrames)
-                .arg((stats.corruptedFrames * 100.0) / stats.totalFrames, 0, 'f', 2);
-            statsText += QString("ACK Lost: %1 (%2%)\n")
-                .arg(stats.ackLostFrames)
-                .arg((stats.ackLostFrames * 100.0) / stats.totalFrames, 0, 'f', 2);
+            statsText += QString("Delivered Frames: %1 (%2%)\n")
+                .arg(link.successes)
+                .arg((link.successes * 100.0) / stats.totalFrames, 0, 'f', 2);
+            statsText += QString("Failed Frames: %1 (%2%)\n")
+                .arg(link.failures)
+                .arg((link.failures * 100.0) / stats.totalFrames, 0, 'f', 2);
         } else {
             statsText += "Total Frames: 0\n";
-            statsText += "Successful Frames: 0 (0%)\n";
-            statsText += "Lost Frames: 0 (0%)\n";
-            statsText += "Corrupted Frames: 0 (0%)\n";
-            statsText += "ACK Lost: 0 (0%)\n";
+            statsText += "Delivered Frames: 0 (0%)\n";
+            statsText += "Failed Frames: 0 (0%)\n";
         }
-        
+
+        // Channel events, as a share of the frames put on the wire
+        const double sent = qMax<qint64>(1, link.attempts);
+        statsText += QString("Frames Sent: %1 (%2 wire bytes)\n").arg(link.attempts).arg(link.wireBytes);
+        statsText += QString("Lost in Transit: %1 (%2%)\n")
+            .arg(link.losses)
+            .arg((link.losses * 100.0) / sent, 0, 'f', 2);
+        statsText += QString("Corrupted in Transit: %1 (%2%)\n")
+            .arg(link.corruptions)
+            .arg((link.corruptions * 100.0) / sent, 0, 'f', 2);
+        statsText += QString("ACK Lost: %1 (%2%)\n")
+            .arg(link.ackLosses)
+            .arg((link.ackLosses * 100.0) / sent, 0, 'f', 2);
+
         statsText += QString("Checksum Errors: %1\n").arg(stats.checksumErrors);
-        
-        statisticsText->setText(statsText);
-        qDebug() << "Statistics updated - Total Frames:" << stats.totalFrames;
+        if (stats.throughput > 0.0) {
+            statsText += QString("Effective Throughput: %1 bit/s\n").arg(stats.throughput, 0, 'f', 1);
+            statsText += QString("Stop-and-Wait Baseline: %1 bit/s\n").arg(stats.stopAndWaitThroughput, 0, 'f', 1);
+        }
+        if (link.attempts > 0) {
+            statsText += QString("Retransmission Ratio: %1 of %2 sent (%3%)\n")
+                .arg(link.retries)
+                .arg(link.attempts)
+                .arg((link.retries * 100.0) / link.attempts, 0, 'f', 2);
+        }
+
+        statisticsText->setPlainText(statsText);
     } catch (const std::exception& e) {
         qDebug() << "Error updating statistics:" << e.what();
         emit errorOccurred(QString("Error updating statistics: %1").arg(e.what()));
@@ -330,69 +413,12 @@ void MainWindow::updateStatistics()
 void MainWindow::updateFrameStatus(const Frame &frame)
 {
     try {
-        qDebug() << "Updating status for frame" << frame.getFrameNumber();
-        qDebug() << "Current Stats - Total Frames:" << stats.totalFrames;
-        
-        processedFrames++;
-        int progress = (processedFrames * 100) / totalFrames;
-        progressBar->setValue(progress);
-        
-        // Update statistics
-        if (frame.isValid()) {
-            stats.successfulFrames++;
-            qDebug() << "Frame" << frame.getFrameNumber() << "processed successfully";
-        } else {
-            auto errorInfo = frame.getErrorInfo();
-            bool errorCounted = false;
-            
-            // Check errors in order of priority
-            if (errorInfo.contains("Lost") && !errorCounted) {
-                stats.lostFrames++;
-                errorCounted = true;
-                qDebug() << "Frame" << frame.getFrameNumber() << "was lost";
-            }
-            if (errorInfo.contains("Corrupted") && !errorCounted) {
-                stats.corruptedFrames++;
-                errorCounted = true;
-                qDebug() << "Frame" << frame.getFrameNumber() << "was corrupted";
-            }
-            if (errorInfo.contains("ACK Lost") && !errorCounted) {
-                stats.ackLostFrames++;
-                errorCounted = true;
-                qDebug() << "Frame" << frame.getFrameNumber() << "ACK was lost";
-            }
-        }
-        
-        qDebug() << "Updated Stats - Total Frames:" << stats.totalFrames;
-        qDebug() << "Updated Stats - Successful Frames:" << stats.successfulFrames;
-        qDebug() << "Updated Stats - Lost Frames:" << stats.lostFrames;
-        qDebug() << "Updated Stats - Corrupted Frames:" << stats.corruptedFrames;
-        qDebug() << "Updated Stats - ACK Lost Frames:" << stats.ackLostFrames;
-        
-        updateStatistics();
-        
-        // Update frame in list
-        bool frameFound = false;
-        for (int i = 0; i < frameList->count(); ++i) {
-            QListWidgetItem *item = frameList->item(i);
-            if (item && item->text().startsWith(QString("Frame %1:").arg(frame.getFrameNumber()))) {
-                item->setText(frame.toString());
-                item->setForeground(frame.isValid() ? Qt::black : Qt::red);
-                frameFound = true;
-                qDebug() << "Updated existing frame" << frame.getFrameNumber() << "in list";
-                break;
-            }
-        }
-        
-        if (!frameFound) {
-            QListWidgetItem *newItem = new QListWidgetItem(frame.toString());
-            newItem->setForeground(frame.isValid() ? Qt::black : Qt::red);
-            frameList->addItem(newItem);
-            qDebug() << "Added new frame" << frame.getFrameNumber() << "to list";
-        }
-        
+        // Counts come from the worker's counters. Rows read the store, which
+        // already holds the new status
+        frameModel->frameChanged(frame.getFrameNumber());
+
         try {
-            updateVisualization(frame, true);
+            updateVisualization(frame);
         } catch (const std::exception& e) {
             qDebug() << "Error updating visualization for frame" << frame.getFrameNumber() << ":" << e.what();
             emit errorOccurred(QString("Error updating visualization: %1").arg(e.what()));
@@ -411,7 +437,8 @@ void MainWindow::onErrorOccurred(const QString &error)
     
     if (error.contains("Checksum")) {
         stats.checksumErrors++;
-        updateStatistics();
+        statisticsDirty = true;
+        scheduleRefresh();
     }
     
     QMessageBox::warning(this, "Error", error);
@@ -419,21 +446,144 @@ void MainWindow::onErrorOccurred(const QString &error)
 
 void MainWindow::onTransmissionComplete()
 {
-    statusLabel->setText("Transmission complete");
+    // The queued completion can overtake the last events in the ring
+    drainEvents();
+    eventTimer->stop();
+    stats.link = datalinkLayer->statsSnapshot();
+    const qint64 dropped = datalinkLayer->droppedEvents() - droppedAtStart;
+    if (dropped > 0) {
+        errorLogText->append(QString("[%1] %2 frame events were dropped while the display was behind; "
+                                     "frame statuses were recorded in full")
+            .arg(QDateTime::currentDateTime().toString("hh:mm:ss.zzz"))
+            .arg(dropped));
+    }
+
+    frameModel->refresh(); // The store now holds the final statuses
+    timeline->refresh();
+
+    setStatus("Transmission complete");
     simulateButton->setEnabled(true);
     simulateButton->setText("Start Transmission");
     progressBar->setVisible(false); // Hide progress bar
-    updateStatistics();
+    statisticsDirty = true;
+    refreshDisplay();
+}
+
+void MainWindow::onTransmissionStopped()
+{
+    // The worker has left the run, so nothing more reaches the ring; take
+    // what is left and let the drain timer rest until the next start
+    drainEvents();
+    if (datalinkLayer->isTransmitting()) {
+        return; // Started again meanwhile; the timer serves the new run
+    }
+    eventTimer->stop();
+    stats.link = datalinkLayer->statsSnapshot();
+    frameModel->refresh(); // The store holds the statuses recorded up to the stop
+    timeline->refresh();
+    statisticsDirty = true;
+    refreshDisplay();
 }
 
 void MainWindow::onStatusUpdate(const QString &status)
 {
-    statusLabel->setText(status);
+    setStatus(status);
     errorLogText->append(QString("[%1] Status: %2")
         .arg(QDateTime::currentDateTime().toString("hh:mm:ss.zzz"))
         .arg(status));
 }
 
+void MainWindow::scheduleRefresh()
+{
+    if (!refreshTimer->isActive()) {
+        refreshTimer->start();
+    }
+}
+
+void MainWindow::setStatus(const QString &status)
+{
+    pendingStatus = status;
+    statusDirty = true;
+    scheduleRefresh();
+}
+
+void MainWindow::refreshDisplay()
+{
+    refreshTimer->stop();
+    if (progressDirty) {
+        const qint64 processed = stats.link.successes + stats.link.failures;
+        const int progress = totalFrames > 0 ? static_cast<int>(qMin<qint64>(100, processed * 100 / totalFrames)) : 0;
+        progressBar->setValue(progress);
+        progressDirty = false;
+    }
+    if (statusDirty) {
+        statusLabel->setText(pendingStatus);
+        statusDirty = false;
+    }
+    if (statisticsDirty) {
+        updateStatistics();
+        statisticsDirty = false;
+    }
+}
+
+void MainWindow::drainEvents()
+{
+    // Bounded per tick so a fast worker cannot starve the event loop
+    int drained = 0;
+    int logged = 0;
+    int unlogged = 0;
+    QString lastStatus;
+    while (drained < MAX_EVENTS_PER_DRAIN) {
+        const int count = datalinkLayer->takeEvents(eventBatch.data(), eventBatch.size());
+        for (int i = 0; i < count; ++i) {
+            const LinkEvent &event = eventBatch.at(i);
+            applyEvent(event);
+            if (event.kind == LinkEvent::FrameDelivered) {
+                continue;
+            }
+            lastStatus = EventChannel::describe(event);
+            if (logged < MAX_LOG_LINES_PER_DRAIN) {
+                errorLogText->append(QString("[%1] Status: %2")
+                    .arg(QDateTime::currentDateTime().toString("hh:mm:ss.zzz"))
+                    .arg(lastStatus));
+                logged++;
+            } else {
+                unlogged++;
+            }
+        }
+        drained += count;
+        if (count < eventBatch.size()) {
+            break;
+        }
+    }
+
+    if (drained > 0) {
+        stats.link = datalinkLayer->statsSnapshot();
+        statisticsDirty = true;
+        progressDirty = true;
+        scheduleRefresh();
+    }
+
+    if (unlogged > 0) {
+        errorLogText->append(QString("[%1] Status: ... %2 more events")
+            .arg(QDateTime::currentDateTime().toString("hh:mm:ss.zzz"))
+            .arg(unlogged));
+    }
+    if (!lastStatus.isEmpty()) {
+        setStatus(lastStatus);
+    }
+}
+
+void MainWindow::applyEvent(const LinkEvent &event)
+{
+    // takeEvents has recorded the status in the store; the row and the
+    // timeline read it from there, so no Frame is built per event
+    if (event.isOutcome()) {
+        frameModel->frameChanged(event.frameIndex);
+        timeline->frameChanged(event.frameIndex);
+    }
+}
+
 void MainWindow::onChecksumCalculated(const QString &checksum)
 {
     checksumLabel->setText(QString("Checksum: 0x%1").arg(checksum.toUpper()));
@@ -449,73 +599,12 @@ void MainWindow::onChecksumFrameSent(const QString &checksumFrame)
         .arg(checksumFrame.toUpper()));
 }
 
-void MainWindow::updateVisualization(const Frame &frame, bool isSending)
+void MainWindow::updateVisualization(const Frame &frame)
 {
-    try {
-        QGraphicsScene *scene = isSending ? sendingScene : receivingScene;
-        if (!scene) {
-            qDebug() << "Error: Scene is null";
-            return;
-        }
-
-        // Calculate position with scrolling support
-        int yPos = static_cast<int>(frame.getFrameNumber() * 40) % static_cast<int>(scene->height());
-        
-        // Create frame rectangle
-        QGraphicsRectItem *frameRect = new QGraphicsRectItem(0, 0, 40, 30);
-        frameRect->setPos(isSending ? 0 : scene->width() - 50, yPos);
-        
-        // Set color based on frame status
-        if (!frame.isValid()) {
-            frameRect->setBrush(QBrush(Qt::red));
-        } else if (frame.isLastFrame()) {
-            frameRect->setBrush(QBrush(Qt::yellow)); // Highlight partial frames
-        } else {
-            frameRect->setBrush(QBrush(Qt::green));
-        }
-        
-        // Add frame number text
-        QGraphicsTextItem *text = new QGraphicsTextItem(QString::number(frame.getFrameNumber()));
-        text->setPos(frameRect->pos().x() + 5, frameRect->pos().y() + 5);
-        
-        // Add to scene
-        scene->addItem(frameRect);
-        scene->addItem(text);
-        
-        // Auto-scroll if needed
-        if (yPos + 40 > scene->height()) {
-            scene->setSceneRect(0, 0, scene->width(), yPos + 50);
-        }
-
-        // Switch visualization view to the correct scene
-        if (isSending) {
-            visualizationView->setScene(sendingScene);
-        } else {
-            visualizationView->setScene(receivingScene);
-        }
-        
-        // Force update
-        scene->update();
-        visualizationView->viewport()->update();
-        
-    } catch (const std::exception& e) {
-        qDebug() << "Error in updateVisualization:" << e.what();
-        emit errorOccurred(QString("Error updating visualization: %1").arg(e.what()));
-    }
+    timeline->frameChanged(frame.getFrameNumber());
 }
 
 void MainWindow::clearVisualization()
 {
-    try {
-        if (sendingScene) {
-            sendingScene->clear();
-        }
-        if (receivingScene) {
-            receivingScene->clear();
-        }
-        visualizationView->viewport()->update();
-    } catch (const std::exception& e) {
-        qDebug() << "Error clearing visualization:" << e.what();
-        emit errorOccurred(QString("Error clearing visualization: %1").arg(e.what()));
-    }
-} 
\ No newline at end of file
+    timeline->refresh();
+}
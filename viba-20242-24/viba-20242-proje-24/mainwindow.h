@@ -3,18 +3,23 @@
 
 #include <QMainWindow>
 #include <QFileDialog>
-#include <QListWidget>
+#include <QListView>
 #include <QLabel>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QProgressBar>
 #include <QTimer>
-#include <QGraphicsScene>
-#include <QGraphicsView>
 #include <QTextEdit>
 #include <QTabWidget>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QFutureWatcher>
 #include "datalinklayer.h"
+#include "montecarlorunner.h"
+#include "framelistmodel.h"
+#include "timelinewidget.h"
 
 class MainWindow : public QMainWindow
 {
@@ -35,17 +40,31 @@ private slots:
     void onChecksumCalculated(const QString &checksum);
     void onChecksumFrameSent(const QString &checksumFrame);
     void onTransmissionComplete();
+    void onTransmissionStopped();
     void onErrorOccurred(const QString &error);
     void onStatusUpdate(const QString &status);
-    void onFrameSelected(QListWidgetItem *item);
+    void onFrameSelected(const QModelIndex &index);
+    void onArqModeChanged(int index);
+    void onFramingChanged(int index);
+    void onThroughputMeasured(double effectiveBitsPerSecond, double stopAndWaitBitsPerSecond);
+    void onRetransmissionsCounted(int transmissions, int retransmissions);
+    void runMonteCarlo();
+    void onMonteCarloFinished();
+    void drainEvents();
+    void refreshDisplay();
 
 private:
     void setupUI();
     void createConnections();
-    void updateVisualization(const Frame &frame, bool isSending);
+    void updateVisualization(const Frame &frame);
     void clearVisualization();
     void updateStatistics();
     void showFrameDetails(const Frame &frame);
+    void applyEvent(const LinkEvent &event);
+    // Counters change per frame; the widgets showing them are refreshed at
+    // most once per REFRESH_INTERVAL_MS by refreshDisplay
+    void scheduleRefresh();
+    void setStatus(const QString &status);
 
     // UI Components
     QWidget *centralWidget;
@@ -55,16 +74,23 @@ private:
     QPushButton *openFileButton;
     QPushButton *processButton;
     QPushButton *simulateButton;
-    QListWidget *frameList;
+    QPushButton *monteCarloButton;
+    QComboBox *arqModeCombo;
+    QComboBox *framingCombo;
+    QSpinBox *windowSizeSpin;
+    QCheckBox *realTimeCheck;
+    QListView *frameList;
     QLabel *checksumLabel;
     QLabel *statusLabel;
     QProgressBar *progressBar;
     
+    // Data Link Layer; declared before the views that read from it
+    DataLinkLayer *datalinkLayer;
+    FrameListModel *frameModel;
+
     // Visualization Components
-    QGraphicsScene *scene;
-    QGraphicsView *visualizationView;
-    QLabel *senderLabel;
-    QLabel *receiverLabel;
+    TimelineWidget *timeline;
+    QLabel *timelineLabel;
 
     // New Components for Detailed View
     QTabWidget *detailsTabWidget;
@@ -72,24 +98,37 @@ private:
     QTextEdit *statisticsText;
     QTextEdit *errorLogText;
 
-    // Data Link Layer
-    DataLinkLayer *datalinkLayer;
+    QFutureWatcher<MonteCarloRunner::Summary> monteCarloWatcher;
+    static const int MONTE_CARLO_TRIALS = 1000;
+    static const quint64 MONTE_CARLO_SEED = 20242;
     int totalFrames;
-    int processedFrames;
     QString currentFilePath;
     
-    // Statistics
+    // Statistics; the transmission counters are snapshots of the worker's
     struct Statistics {
         int totalFrames = 0;
-        int successfulFrames = 0;
-        int lostFrames = 0;
-        int corruptedFrames = 0;
-        int ackLostFrames = 0;
+        LinkStats link;
         int checksumErrors = 0;
+        double throughput = 0.0;
+        double stopAndWaitThroughput = 0.0;
     } stats;
 
-    QGraphicsScene *sendingScene;
-    QGraphicsScene *receivingScene;
+    // Transmission events are drained from the worker's ring on this timer,
+    // in batches, instead of arriving one queued signal per frame
+    QTimer *eventTimer;
+    QVector<LinkEvent> eventBatch;
+    qint64 droppedAtStart;
+    static const int EVENT_DRAIN_INTERVAL_MS = 33;
+    static const int EVENT_BATCH_SIZE = 4096;
+    static const int MAX_EVENTS_PER_DRAIN = EventChannel::DEFAULT_CAPACITY;
+    static const int MAX_LOG_LINES_PER_DRAIN = 50;
+
+    QTimer *refreshTimer;
+    bool statisticsDirty;
+    bool progressDirty;
+    bool statusDirty;
+    QString pendingStatus;
+    static const int REFRESH_INTERVAL_MS = 33; // About 30 Hz
 };
 
 #endif // MAINWINDOW_H 
\ No newline at end of file
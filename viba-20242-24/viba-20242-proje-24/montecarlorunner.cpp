@@ -0,0 +1,149 @@
+#include "montecarlorunner.h"
+#include <QtConcurrent>
+#include <QtMath>
+
+namespace {
+// z for a two-sided 95% interval
+const double Z_95 = 1.959963984540054;
+
+// Picks one sample out of every trial
+template <typename Field>
+QVector<double> column(const QVector<DataLinkWorker::TrialResult> &results, Field field)
+{
+    QVector<double> samples;
+    samples.reserve(results.size());
+    for (const DataLinkWorker::TrialResult &result : results) {
+        samples.append(field(result));
+    }
+    return samples;
+}
+}
+
+MonteCarloRunner::MonteCarloRunner()
+    : arqMode(ArqMode::StopAndWait)
+    , framingMode(FramingMode::ByteStuffing)
+    , windowSize(DataLinkWorker::DEFAULT_WINDOW_SIZE)
+{
+}
+
+void MonteCarloRunner::setData(const FrameStore &newStore)
+{
+    store = newStore;
+}
+
+void MonteCarloRunner::setArqMode(ArqMode mode, int window)
+{
+    arqMode = mode;
+    windowSize = window;
+}
+
+void MonteCarloRunner::setFramingMode(FramingMode mode)
+{
+    framingMode = mode;
+}
+
+void MonteCarloRunner::setChannelParameters(const BurstChannel::Parameters &parameters)
+{
+    channelParameters = parameters;
+}
+
+QVector<DataLinkWorker::TrialResult> MonteCarloRunner::runTrials(int trials, quint64 seed) const
+{
+    QVector<DataLinkWorker::TrialResult> results(qMax(0, trials));
+    for (int i = 0; i < results.size(); ++i) {
+        results[i].seed = trialSeed(seed, i);
+    }
+
+    // Every trial has its own worker and RNG; the store is shared read-only
+    QtConcurrent::blockingMap(results, [this](DataLinkWorker::TrialResult &result) {
+        DataLinkWorker worker;
+        worker.setData(store);
+        worker.setArqMode(arqMode, windowSize);
+        worker.setFramingMode(framingMode);
+        worker.setChannelParameters(channelParameters);
+        result = worker.runTrial(result.seed);
+    });
+    return results;
+}
+
+MonteCarloRunner::Summary MonteCarloRunner::run(int trials, quint64 seed) const
+{
+    return summarize(runTrials(trials, seed), seed);
+}
+
+MonteCarloRunner::Summary MonteCarloRunner::summarize(const QVector<DataLinkWorker::TrialResult> &results, quint64 seed)
+{
+    typedef DataLinkWorker::TrialResult Trial;
+
+    Summary summary;
+    summary.trials = results.size();
+    summary.seed = seed;
+    summary.goodput = estimate(column(results, [](const Trial &t) { return t.goodput; }));
+    summary.retransmissions = estimate(column(results, [](const Trial &t) { return double(t.retransmissions); }));
+    summary.lostFrames = estimate(column(results, [](const Trial &t) { return double(t.lostFrames); }));
+    summary.corruptedFrames = estimate(column(results, [](const Trial &t) { return double(t.corruptedFrames); }));
+    summary.ackLosses = estimate(column(results, [](const Trial &t) { return double(t.ackLosses); }));
+    summary.failedFrames = estimate(column(results, [](const Trial &t) { return double(t.failedFrames); }));
+    summary.simulatedSeconds = estimate(column(results, [](const Trial &t) { return t.simulatedMs / 1000.0; }));
+    return summary;
+}
+
+quint64 MonteCarloRunner::trialSeed(quint64 seed, int trial)
+{
+    // SplitMix64 step: neighbouring trials get unrelated seeds
+    quint64 z = seed + 0x9E3779B97F4A7C15ULL * (quint64(trial) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+MonteCarloRunner::Estimate MonteCarloRunner::estimate(const QVector<double> &samples)
+{
+    Estimate result;
+    const int n = samples.size();
+    if (n == 0) {
+        return result;
+    }
+
+    // Two passes in sample order keep the sums independent of scheduling
+    double sum = 0.0;
+    for (double value : samples) {
+        sum += value;
+    }
+    result.mean = sum / n;
+
+    if (n > 1) {
+        double squares = 0.0;
+        for (double value : samples) {
+            squares += (value - result.mean) * (value - result.mean);
+        }
+        result.variance = squares / (n - 1);
+    }
+
+    const double halfWidth = Z_95 * qSqrt(result.variance / n);
+    result.ciLow = result.mean - halfWidth;
+    result.ciHigh = result.mean + halfWidth;
+    return result;
+}
+
+QString MonteCarloRunner::formatSummary(const Summary &summary)
+{
+    auto line = [](const QString &name, const Estimate &e) {
+        return QString("%1: mean %2, variance %3, 95% CI [%4, %5]\n")
+            .arg(name)
+            .arg(e.mean, 0, 'f', 3)
+            .arg(e.variance, 0, 'f', 3)
+            .arg(e.ciLow, 0, 'f', 3)
+            .arg(e.ciHigh, 0, 'f', 3);
+    };
+
+    QString text = QString("=== Monte Carlo: %1 trials, seed %2 ===\n\n").arg(summary.trials).arg(summary.seed);
+    text += line("Goodput (bit/s)", summary.goodput);
+    text += line("Retransmissions", summary.retransmissions);
+    text += line("Lost Frames", summary.lostFrames);
+    text += line("Corrupted Frames", summary.corruptedFrames);
+    text += line("ACK Losses", summary.ackLosses);
+    text += line("Failed Frames", summary.failedFrames);
+    text += line("Simulated Time (s)", summary.simulatedSeconds);
+    return text;
+}
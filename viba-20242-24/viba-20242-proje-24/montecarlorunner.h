@@ -0,0 +1,58 @@
+#ifndef MONTECARLORUNNER_H
+#define MONTECARLORUNNER_H
+
+#include <QString>
+#include <QVector>
+#include "datalinklayer.h"
+
+// Runs many independent transmissions of the same frames and channel
+// settings across all cores. Trial i draws its channel from a seed derived
+// from (seed, i) and results are reduced in trial order, so a summary is
+// bit-for-bit reproducible for a given seed, whatever the thread count.
+class MonteCarloRunner
+{
+public:
+    // Mean, sample variance and 95% confidence interval of one metric
+    struct Estimate {
+        double mean = 0.0;
+        double variance = 0.0;
+        double ciLow = 0.0;
+        double ciHigh = 0.0;
+    };
+
+    struct Summary {
+        int trials = 0;
+        quint64 seed = 0;
+        Estimate goodput;         // bit/s of simulated time
+        Estimate retransmissions;
+        Estimate lostFrames;
+        Estimate corruptedFrames;
+        Estimate ackLosses;
+        Estimate failedFrames;
+        Estimate simulatedSeconds;
+    };
+
+    MonteCarloRunner();
+
+    void setData(const FrameStore &newStore);
+    void setArqMode(ArqMode mode, int window);
+    void setFramingMode(FramingMode mode);
+    void setChannelParameters(const BurstChannel::Parameters &parameters);
+
+    Summary run(int trials, quint64 seed) const;
+    QVector<DataLinkWorker::TrialResult> runTrials(int trials, quint64 seed) const;
+    static Summary summarize(const QVector<DataLinkWorker::TrialResult> &results, quint64 seed);
+
+    static quint64 trialSeed(quint64 seed, int trial);
+    static Estimate estimate(const QVector<double> &samples);
+    static QString formatSummary(const Summary &summary);
+
+private:
+    FrameStore store;
+    ArqMode arqMode;
+    FramingMode framingMode;
+    BurstChannel::Parameters channelParameters;
+    int windowSize;
+};
+
+#endif // MONTECARLORUNNER_H
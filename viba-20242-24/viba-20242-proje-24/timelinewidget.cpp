@@ -0,0 +1,292 @@
+#include "timelinewidget.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QResizeEvent>
+#include <QVBoxLayout>
+
+TimelineWidget::TimelineWidget(DataLinkLayer *layer, QWidget *parent)
+    : QWidget(parent)
+    , layer(layer)
+    , frameCount(0)
+    , blockShift(MIN_BLOCK_SHIFT)
+    , anyDirty(false)
+    , scrollBar(new QScrollBar(Qt::Horizontal, this))
+    , pixelsPerFrame(DEFAULT_PIXELS_PER_FRAME)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addStretch();
+    layout->addWidget(scrollBar);
+
+    setMinimumHeight(60);
+    connect(scrollBar, &QScrollBar::valueChanged, this, [this]() { update(); });
+}
+
+QSize TimelineWidget::sizeHint() const
+{
+    return QSize(400, 100);
+}
+
+void TimelineWidget::reload()
+{
+    frameCount = layer->frameCount();
+    resetLevels();
+    pixelsPerFrame = qBound(minZoom(), DEFAULT_PIXELS_PER_FRAME, MAX_PIXELS_PER_FRAME);
+    updateScrollRange();
+    scrollBar->setValue(0);
+    update();
+}
+
+void TimelineWidget::frameChanged(int frameIndex)
+{
+    if (frameIndex < 0 || frameIndex >= frameCount) {
+        return;
+    }
+    dirtyBlocks[frameIndex >> blockShift] = true;
+    anyDirty = true;
+    update();
+}
+
+void TimelineWidget::refresh()
+{
+    dirtyBlocks.fill(true);
+    anyDirty = !dirtyBlocks.isEmpty();
+    update();
+}
+
+void TimelineWidget::setZoom(double zoom)
+{
+    // Anchor the first visible frame
+    const int first = scrollBar->value();
+    pixelsPerFrame = qBound(minZoom(), zoom, MAX_PIXELS_PER_FRAME);
+    updateScrollRange();
+    scrollBar->setValue(first);
+    update();
+}
+
+double TimelineWidget::zoom() const
+{
+    return pixelsPerFrame;
+}
+
+TimelineWidget::State TimelineWidget::stateOf(const FrameStore &store, int index)
+{
+    // Mapped stores keep no statuses
+    if (store.isMapped() || index >= store.count()) {
+        return Pending;
+    }
+    const int attempts = store.attempts(index);
+    if (store.status(index) & (Frame::TransmissionFailed | Frame::CRCMismatch)) {
+        return Failed;
+    }
+    if (attempts == 0) {
+        return Pending;
+    }
+    return attempts > 1 ? Retried : Delivered;
+}
+
+QColor TimelineWidget::colorOf(State state)
+{
+    switch (state) {
+    case Delivered:
+        return QColor(76, 175, 80);
+    case Retried:
+        return QColor(255, 193, 7);
+    case Failed:
+        return QColor(229, 57, 53);
+    default:
+        return QColor(224, 224, 224);
+    }
+}
+
+void TimelineWidget::resetLevels()
+{
+    levels.clear();
+    dirtyBlocks.clear();
+    anyDirty = false;
+    if (frameCount == 0) {
+        return;
+    }
+
+    // Empty levels, every block dirty: the first paint counts them all
+    blockShift = MIN_BLOCK_SHIFT;
+    while (((qint64(frameCount) - 1) >> blockShift) + 1 > MAX_BLOCKS) {
+        blockShift++;
+    }
+    int blocks = static_cast<int>(((qint64(frameCount) - 1) >> blockShift) + 1);
+    levels.append(QVector<Block>(blocks, Block{}));
+    while (blocks > 1) {
+        blocks = (blocks + 1) / 2;
+        levels.append(QVector<Block>(blocks, Block{}));
+    }
+    dirtyBlocks.fill(true, levels.first().size());
+    anyDirty = true;
+}
+
+void TimelineWidget::recountDirtyBlocks(const FrameStore &store)
+{
+    if (!anyDirty) {
+        return;
+    }
+    anyDirty = false;
+
+    const qint64 blockSize = qint64(1) << blockShift;
+    for (int b = 0; b < dirtyBlocks.size(); ++b) {
+        if (!dirtyBlocks.at(b)) {
+            continue;
+        }
+        dirtyBlocks[b] = false;
+
+        Block fresh{};
+        const qint64 end = qMin<qint64>(frameCount, (b + 1) * blockSize);
+        for (qint64 i = b * blockSize; i < end; ++i) {
+            fresh.counts[stateOf(store, static_cast<int>(i))]++;
+        }
+        // Every level's block covering this one moves by the same difference
+        const Block old = levels.at(0).at(b);
+        for (int level = 0; level < levels.size(); ++level) {
+            Block &block = levels[level][b >> level];
+            for (int s = 0; s < STATE_COUNT; ++s) {
+                block.counts[s] += fresh.counts[s] - old.counts[s];
+            }
+        }
+    }
+}
+
+void TimelineWidget::countRange(const FrameStore &store, qint64 begin, qint64 end, quint32 counts[STATE_COUNT]) const
+{
+    // Cover [begin, end) with the largest aligned blocks that fit, and the
+    // ragged ends frame by frame from the store: O(levels + block size) per column
+    qint64 position = begin;
+    while (position < end) {
+        int level = levels.size() - 1;
+        for (; level >= 0; --level) {
+            const qint64 size = qint64(1) << (blockShift + level);
+            if ((position & (size - 1)) == 0 && position + size <= end) {
+                break;
+            }
+        }
+        if (level < 0) {
+            counts[stateOf(store, static_cast<int>(position))]++;
+            position++;
+            continue;
+        }
+        const Block &block = levels.at(level).at(position >> (blockShift + level));
+        for (int s = 0; s < STATE_COUNT; ++s) {
+            counts[s] += block.counts[s];
+        }
+        position += qint64(1) << (blockShift + level);
+    }
+}
+
+void TimelineWidget::updateScrollRange()
+{
+    const int visible = qMax(1, static_cast<int>(width() / pixelsPerFrame));
+    scrollBar->setRange(0, qMax(0, frameCount - visible));
+    scrollBar->setPageStep(visible);
+    scrollBar->setSingleStep(qMax(1, visible / 10));
+}
+
+double TimelineWidget::minZoom() const
+{
+    // Zoomed all the way out, the whole transmission fits the width
+    if (frameCount == 0) {
+        return MAX_PIXELS_PER_FRAME;
+    }
+    return qMin(MAX_PIXELS_PER_FRAME, qMax(1, width()) / static_cast<double>(frameCount));
+}
+
+int TimelineWidget::stripHeight() const
+{
+    return qMax(1, height() - scrollBar->height());
+}
+
+void TimelineWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    const int strip = stripHeight();
+    painter.fillRect(QRect(0, 0, width(), strip), palette().color(QPalette::Base));
+    if (frameCount == 0) {
+        return;
+    }
+
+    // A shared copy, gone again before the next status is recorded, so it
+    // never makes the store detach
+    const FrameStore store = layer->frameStore();
+    recountDirtyBlocks(store);
+    const qint64 first = scrollBar->value();
+
+    if (pixelsPerFrame >= 1.0) {
+        // One cell per visible frame
+        const qint64 last = qMin<qint64>(frameCount, first + static_cast<qint64>(width() / pixelsPerFrame) + 1);
+        const int gap = pixelsPerFrame >= 4.0 ? 1 : 0;
+        const bool labels = pixelsPerFrame >= LABEL_MIN_PIXELS;
+        painter.setPen(Qt::black);
+        for (qint64 i = first; i < last; ++i) {
+            const int x = static_cast<int>((i - first) * pixelsPerFrame);
+            const int next = static_cast<int>((i - first + 1) * pixelsPerFrame);
+            const QRect cell(x, 0, qMax(1, next - x - gap), strip);
+            painter.fillRect(cell, colorOf(stateOf(store, static_cast<int>(i))));
+            if (labels) {
+                painter.drawText(cell, Qt::AlignCenter, QString::number(i));
+            }
+        }
+        return;
+    }
+
+    // Level of detail: each column stacks the share of every outcome among
+    // the frames it covers, failures at the bottom. Any failure gets at
+    // least a pixel so single failures stay visible at every zoom.
+    const double framesPerColumn = 1.0 / pixelsPerFrame;
+    const State stacked[] = { Failed, Retried, Delivered };
+    for (int x = 0; x < width(); ++x) {
+        const qint64 begin = first + static_cast<qint64>(x * framesPerColumn);
+        const qint64 end = qMin<qint64>(frameCount, first + static_cast<qint64>((x + 1) * framesPerColumn));
+        if (begin >= end) {
+            break;
+        }
+        quint32 counts[STATE_COUNT] = {};
+        countRange(store, begin, end, counts);
+
+        painter.fillRect(x, 0, 1, strip, colorOf(Pending));
+        int y = strip;
+        for (State state : stacked) {
+            if (counts[state] == 0) {
+                continue;
+            }
+            const int h = qMax(1, qRound(strip * double(counts[state]) / double(end - begin)));
+            y -= h;
+            painter.fillRect(x, y, 1, h, colorOf(state));
+        }
+    }
+}
+
+void TimelineWidget::wheelEvent(QWheelEvent *event)
+{
+    const int steps = event->angleDelta().y() / 120;
+    if (steps == 0 || frameCount == 0) {
+        event->ignore();
+        return;
+    }
+
+    // Zoom around the frame under the cursor
+    const double x = event->position().x();
+    const double anchor = scrollBar->value() + x / pixelsPerFrame;
+    double zoom = pixelsPerFrame;
+    for (int i = 0; i < qAbs(steps); ++i) {
+        zoom = (steps > 0) ? zoom * ZOOM_FACTOR : zoom / ZOOM_FACTOR;
+    }
+    pixelsPerFrame = qBound(minZoom(), zoom, MAX_PIXELS_PER_FRAME);
+    updateScrollRange();
+    scrollBar->setValue(static_cast<int>(anchor - x / pixelsPerFrame));
+    update();
+    event->accept();
+}
+
+void TimelineWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    pixelsPerFrame = qBound(minZoom(), pixelsPerFrame, MAX_PIXELS_PER_FRAME);
+    updateScrollRange();
+}
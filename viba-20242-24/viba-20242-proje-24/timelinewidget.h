@@ -0,0 +1,84 @@
+#ifndef TIMELINEWIDGET_H
+#define TIMELINEWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include <QScrollBar>
+#include "datalinklayer.h"
+
+// Transmission timeline: frames run along the x axis, coloured by outcome.
+// Statuses are read from the DataLinkLayer's store when painting, and only
+// for the visible frames. Zoomed out, each pixel column covers many frames
+// and shows the share of every outcome among them, summed from a pyramid of
+// per-block counts. The pyramid has at most MAX_BLOCKS blocks on its finest
+// level, so the widget holds about 2 MB at most, whatever the frame count;
+// nothing is kept per frame.
+class TimelineWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TimelineWidget(DataLinkLayer *layer, QWidget *parent = nullptr);
+
+    // Picks up a newly loaded file
+    void reload();
+    // One frame's status changed in the store
+    void frameChanged(int frameIndex);
+    // Every frame's status may have changed, e.g. at the start or end of a run
+    void refresh();
+
+    // Horizontal pixels per frame; below 1, frames are aggregated per column
+    void setZoom(double pixelsPerFrame);
+    double zoom() const;
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    enum State : quint8 {
+        Pending,
+        Delivered,
+        Retried, // Delivered, but not on the first attempt
+        Failed,
+        STATE_COUNT
+    };
+
+    // Outcome counts of one aligned block of frames
+    struct Block {
+        quint32 counts[STATE_COUNT];
+    };
+
+    // Blocks on level l hold 2^(blockShift + l) frames, with blockShift at
+    // least MIN_BLOCK_SHIFT and large enough for level 0 to stay within
+    // MAX_BLOCKS; anything finer is read from the store
+    static const int MIN_BLOCK_SHIFT = 6;
+    static const int MAX_BLOCKS = 1 << 16;
+    static constexpr double MAX_PIXELS_PER_FRAME = 32.0;
+    static constexpr double DEFAULT_PIXELS_PER_FRAME = 12.0;
+    static constexpr double ZOOM_FACTOR = 1.25; // Per wheel notch
+    static const int LABEL_MIN_PIXELS = 28;
+
+    static State stateOf(const FrameStore &store, int index);
+    static QColor colorOf(State state);
+    void resetLevels();
+    void recountDirtyBlocks(const FrameStore &store);
+    void countRange(const FrameStore &store, qint64 begin, qint64 end, quint32 counts[STATE_COUNT]) const;
+    void updateScrollRange();
+    double minZoom() const;
+    int stripHeight() const;
+
+    DataLinkLayer *layer;
+    int frameCount;
+    int blockShift;
+    QVector<QVector<Block>> levels;
+    QVector<bool> dirtyBlocks; // Level-0 blocks to recount from the store
+    bool anyDirty;
+    QScrollBar *scrollBar;
+    double pixelsPerFrame;
+};
+
+#endif // TIMELINEWIDGET_H
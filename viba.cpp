@@ -9,6 +9,7 @@
 #include <iomanip>
 
 constexpr int FRAME_SIZE_BITS = 100;
+constexpr int CRC_BITS = 16;
 constexpr uint16_t CRC_POLY = 0x1021;
 
 class MainFrame : public wxFrame {
@@ -151,20 +152,20 @@ private:
     }
 
     std::string CalculateCRC(const std::string& frame) {
-        std::string data = frame + std::string(16, '0');
-        std::bitset<116> bits(data);
-        std::bitset<17> poly(CRC_POLY);
+        std::string data = frame + std::string(CRC_BITS, '0');
+        std::bitset<FRAME_SIZE_BITS + CRC_BITS> bits(data);
+        std::bitset<CRC_BITS + 1> poly(CRC_POLY);
 
-        for (int i = 115; i >= 16; --i) {
+        for (int i = FRAME_SIZE_BITS + CRC_BITS - 1; i >= CRC_BITS; --i) {
             if (bits[i]) {
-                for (int j = 0; j <= 16; ++j) {
-                    bits[i - j] = bits[i - j] ^ poly.test(16 - j);
+                for (int j = 0; j <= CRC_BITS; ++j) {
+                    bits[i - j] = bits[i - j] ^ poly.test(CRC_BITS - j);
                 }
             }
         }
 
-        std::bitset<16> crc;
-        for (int i = 0; i < 16; ++i)
+        std::bitset<CRC_BITS> crc;
+        for (int i = 0; i < CRC_BITS; ++i)
             crc[i] = bits[i];
 
         return crc.to_string();